@@ -48,7 +48,7 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-
+LCD_HandleTypeDef hlcd1; ///?> Дисплей LCD1602
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -96,21 +96,35 @@ int main(void)
   MX_USART1_UART_Init();
   /* USER CODE BEGIN 2 */
   HAL_TIM_Encoder_Start(&htim8, TIM_CHANNEL_ALL);
-  LCD_Init();
-  LCD_SetCursor(1, 0);
-#if (LCD_DATA_TRANSPORT == LCD_DATA_GPIO)
+#if (LCD_DATA_TRANSPORT_GPIO != 0)
+  hlcd1.Transport = &LCD_TransportGpio;
 #if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
   char *str = "GPIO 8 Bit";
 #elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
   char *str = "GPIO 4 Bit";
 #endif
-#elif (LCD_DATA_TRANSPORT == LCD_DATA_74HC595)
+#elif (LCD_DATA_TRANSPORT_74HC595 != 0)
+  hlcd1.Transport = &LCD_Transport74HC595;
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+  char *str = "74HC595 8 Bit";
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
   char *str = "74HC595 4 Bit";
-#elif (LCD_DATA_TRANSPORT == LCD_DATA_PCF8574T)
+#endif
+#elif (LCD_DATA_TRANSPORT_PCF8574T != 0)
+  hlcd1.Transport = &LCD_TransportPCF8574T;
+  hlcd1.Bus       = &hi2c1;
+  hlcd1.Address   = 0x27;
   char *str = "PCF8574T 4 Bit";
+#elif (LCD_DATA_TRANSPORT_FSMC != 0)
+  hlcd1.Transport = &LCD_TransportFSMC;
+  char *str = "FSMC 8 Bit";
 #endif
+  hlcd1.Geometry = &LCD_Geometry16x2;
+  LCD_Init(&hlcd1);
+  LCD_SetCursor(&hlcd1, 1, 0);
 
-  LCD_SendString(str, strlen(str));
+  LCD_SendString(&hlcd1, str, strlen(str));
+  LCD_Flush(&hlcd1);
 
   /* USER CODE END 2 */
 
@@ -171,7 +185,27 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+#if (LCD_DATA_TRANSPORT_PCF8574T != 0) && (LCD_PCF8574T_DMA != 0)
+/**
+  * @brief  I2C master Tx transfer completed callback: LCD frames via DMA
+  * @param  hi2c : I2C handle
+  * @retval None
+  */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  LCD_I2cTxCplt(hi2c);
+}
 
+/**
+  * @brief  I2C error callback: LCD frames via DMA
+  * @param  hi2c : I2C handle
+  * @retval None
+  */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  LCD_I2cError(hi2c);
+}
+#endif
 /* USER CODE END 4 */
 
 /**
@@ -22,6 +22,7 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "lcd_data_transport.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -216,5 +217,122 @@ void TIM8_TRG_COM_TIM14_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+#if (LCD_ASYNC_MODE != 0)
+/**
+  * @brief This function handles TIM7 global interrupt (LCD transmit engine).
+  */
+void TIM7_IRQHandler(void)
+{
+  LCD_AsyncIRQHandler();
+}
+#endif
+#if (LCD_DATA_TRANSPORT_GPIO != 0) && (LCD_GPIO_DMA != 0)
+/**
+  * @brief This function handles DMA2 stream5 global interrupt (LCD frame output).
+  */
+void DMA2_Stream5_IRQHandler(void)
+{
+  LCD_GpioDmaIRQHandler();
+}
+#endif
+#if (LCD_DATA_TRANSPORT_FSMC != 0) && (LCD_FSMC_DMA != 0)
+/**
+  * @brief This function handles DMA2 stream5 global interrupt (LCD FSMC row).
+  */
+void DMA2_Stream5_IRQHandler(void)
+{
+  LCD_FsmcDmaIRQHandler();
+}
+
+/**
+  * @brief This function handles TIM1 update and TIM10 global interrupts.
+  */
+void TIM1_UP_TIM10_IRQHandler(void)
+{
+  LCD_FsmcTimIRQHandler();
+}
+#endif
+#if (LCD_DATA_TRANSPORT_74HC595 != 0) && (LCD_74HC595_SPI != 0) && (LCD_74HC595_DMA != 0)
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (LCD SPI2 frame).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  LCD_SpiDmaIRQHandler();
+}
+#endif
+#if (LCD_DATA_TRANSPORT_PCF8574T != 0) && (LCD_PCF8574T_DMA != 0)
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (LCD I2C1 TX).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  LCD_I2cDmaIRQHandler(I2C1);
+}
+
+/**
+  * @brief This function handles I2C1 event interrupt.
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  LCD_I2cEvIRQHandler(I2C1);
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt.
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  LCD_I2cErIRQHandler(I2C1);
+}
+
+/**
+  * @brief This function handles DMA1 stream7 global interrupt (LCD I2C2 TX).
+  */
+void DMA1_Stream7_IRQHandler(void)
+{
+  LCD_I2cDmaIRQHandler(I2C2);
+}
+
+/**
+  * @brief This function handles I2C2 event interrupt.
+  */
+void I2C2_EV_IRQHandler(void)
+{
+  LCD_I2cEvIRQHandler(I2C2);
+}
+
+/**
+  * @brief This function handles I2C2 error interrupt.
+  */
+void I2C2_ER_IRQHandler(void)
+{
+  LCD_I2cErIRQHandler(I2C2);
+}
+
+/**
+  * @brief This function handles DMA1 stream4 global interrupt (LCD I2C3 TX).
+  */
+void DMA1_Stream4_IRQHandler(void)
+{
+  LCD_I2cDmaIRQHandler(I2C3);
+}
+
+/**
+  * @brief This function handles I2C3 event interrupt.
+  */
+void I2C3_EV_IRQHandler(void)
+{
+  LCD_I2cEvIRQHandler(I2C3);
+}
+
+/**
+  * @brief This function handles I2C3 error interrupt.
+  */
+void I2C3_ER_IRQHandler(void)
+{
+  LCD_I2cErIRQHandler(I2C3);
+}
+#endif
 
 /* USER CODE END 1 */
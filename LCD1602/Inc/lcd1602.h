@@ -9,10 +9,81 @@
 #ifndef INC_LCD1602_H_
 #define INC_LCD1602_H_
 
-void LCD_SetCursor    (uint8_t row, uint8_t col);
-void LCD_Init         (void);
-void LCD_SetCursor    (uint8_t row, uint8_t col);
-void LCD_SendString   (char *str, uint8_t size);
-void LCD_Clear        (void);
+#include "main.h"
+#include "lcd_data_transport.h"
+
+#define LCD_ROWS 4  ///?> Наибольшее количество строк дисплея (размер теневого буфера, не больше 4)
+#define LCD_COLS 40 ///?> Наибольшее количество символов в строке
+
+#define LCD_DIRTY_BYTES ((LCD_COLS + 7) / 8) ///?> Размер строки битовой карты изменённых ячеек
+#define LCD_NO_ADDRESS  0xFF                 ///?> Адрес DDRAM контроллера неизвестен
+
+/// Геометрия модуля: видимые строки и их адреса в DDRAM контроллера.
+/// Адрес ячейки -- RowOffset[row] + col, строка 16x1 второго типа
+/// с колонки SplitCol продолжается во второй строке контроллера (0x40)
+typedef struct {
+	uint8_t Rows;         ///?> Количество строк
+	uint8_t Cols;         ///?> Количество символов в строке
+	uint8_t Lines;        ///?> Строк контроллера (бит N команды Function Set): 1 или 2
+	uint8_t SplitCol;     ///?> Колонка перехода во вторую строку контроллера, 0 -- нет
+	uint8_t RowOffset[4]; ///?> Адрес DDRAM начала каждой строки
+	uint8_t E2Row;        ///?> Первая строка второго контроллера (строб E2), 0 -- контроллер один
+} LCD_GeometryTypeDef;
+
+extern const LCD_GeometryTypeDef LCD_Geometry16x1;      ///?> 16x1, адреса 0x00-0x0F (однострочный режим)
+extern const LCD_GeometryTypeDef LCD_Geometry16x1Split; ///?> 16x1, 8 символов с 0x00 и 8 с 0x40
+extern const LCD_GeometryTypeDef LCD_Geometry16x2;      ///?> 16x2
+extern const LCD_GeometryTypeDef LCD_Geometry16x4;      ///?> 16x4, строки 3-4 продолжают строки 1-2 (0x10, 0x50)
+extern const LCD_GeometryTypeDef LCD_Geometry20x2;      ///?> 20x2
+extern const LCD_GeometryTypeDef LCD_Geometry20x4;      ///?> 20x4, строки 3-4 продолжают строки 1-2 (0x14, 0x54)
+extern const LCD_GeometryTypeDef LCD_Geometry40x2;      ///?> 40x2
+extern const LCD_GeometryTypeDef LCD_Geometry40x4;      ///?> 40x4, два контроллера 40x2 (E1 -- строки 1-2, E2 -- строки 3-4)
+
+/// Дескриптор дисплея. Память выделяет приложение (статически),
+/// настройки заполняются до LCD_Init, состояние ведёт драйвер
+struct __LCD_HandleTypeDef
+{
+	const LCD_TransportTypeDef *Transport; ///?> Транспорт (&LCD_TransportGpio, &LCD_TransportPCF8574T, ...)
+	void          *Bus;                  ///?> Шина: PCF8574T -- I2C_HandleTypeDef (NULL -- hi2c1)
+	uint8_t        Address;              ///?> PCF8574T -- 7-битный адрес I2C (0 -- 0x27), FSMC -- банк 0-3 (NE1-NE4)
+	GPIO_TypeDef  *EPort;                ///?> Порт строба E (GPIO) или защёлки RCLK (74HC595), NULL -- пин из main.h
+	uint16_t       EPin;                 ///?> Пин строба E / защёлки RCLK
+	GPIO_TypeDef  *E2Port;               ///?> Порт строба E2 второго контроллера (GPIO, 40x4)
+	uint16_t       E2Pin;                ///?> Пин строба E2
+	const LCD_GeometryTypeDef *Geometry; ///?> Геометрия модуля, NULL -- LCD_Geometry16x2
+
+	uint8_t        Id;                   ///?> Номер дисплея в реестре драйвера (назначается LCD_Init)
+	void          *Context;              ///?> Состояние транспорта этого дисплея
+	uint8_t        Enable;               ///?> Контроллеры, которым идут инструкции (LCD_ENABLE_*)
+	uint8_t        Pending;              ///?> Контроллеры, которые могут ещё выполнять инструкцию
+	uint32_t       Issued[2];            ///?> Момент отправки последней инструкции каждого контроллера (DWT)
+	uint16_t       Busy[2];              ///?> Время выполнения последней инструкции каждого контроллера, мкс
+	uint8_t        Counter[2];           ///?> Счётчик адреса DDRAM (AC) каждого контроллера, LCD_NO_ADDRESS -- неизвестен
+	uint8_t        Shift;                ///?> Сдвиг изображения влево (Display Shift), ячеек строки DDRAM
+	uint8_t        Cgram;                ///?> Последний Set Address -- в CGRAM: запись данных не сдвигает изображение
+	uint8_t        EntryMode;            ///?> Теневой регистр: последняя команда Entry Mode Set (бит I/D -- направление AC)
+	uint8_t        DisplayControl;       ///?> Теневой регистр: последняя команда Display On/Off Control, 0 -- неизвестна
+	uint8_t        FunctionSet;          ///?> Теневой регистр: последняя команда Function Set, 0 -- неизвестна
+	uint8_t        Frame[LCD_ROWS][LCD_COLS];        ///?> Теневая копия DDRAM (то, что должно быть на экране)
+	uint8_t        Dirty[LCD_ROWS][LCD_DIRTY_BYTES]; ///?> Битовая карта ячеек, ещё не отправленных в дисплей
+	uint8_t        Blank[LCD_ROWS][LCD_DIRTY_BYTES]; ///?> Ячейки, стёртые LCD_SoftClear: в Frame ещё символ на экране, нужен пробел
+	uint8_t        Row;                  ///?> Строка курсора теневого буфера
+	uint8_t        Col;                  ///?> Колонка курсора теневого буфера
+};
+
+void LCD_Init         (LCD_HandleTypeDef *hlcd);
+void LCD_SetCursor    (LCD_HandleTypeDef *hlcd, uint8_t row, uint8_t col);
+void LCD_SendString   (LCD_HandleTypeDef *hlcd, char *str, uint8_t size);
+void LCD_Flush        (LCD_HandleTypeDef *hlcd);
+void LCD_FlushAll     (LCD_HandleTypeDef *const *hlcd, uint8_t count);
+uint8_t LCD_FlushPart (LCD_HandleTypeDef *hlcd, uint16_t cells);
+uint8_t LCD_IsDirty   (LCD_HandleTypeDef *hlcd);
+void LCD_Clear        (LCD_HandleTypeDef *hlcd);
+void LCD_SoftClear    (LCD_HandleTypeDef *hlcd);
+void LCD_DisplayOn    (LCD_HandleTypeDef *hlcd, uint8_t on);
+void LCD_CursorOn     (LCD_HandleTypeDef *hlcd, uint8_t on);
+void LCD_BlinkOn      (LCD_HandleTypeDef *hlcd, uint8_t on);
+void LCD_LeftToRight  (LCD_HandleTypeDef *hlcd, uint8_t ltr);
+void LCD_Autoscroll   (LCD_HandleTypeDef *hlcd, uint8_t on);
 
 #endif /* INC_LCD1602_H_ */
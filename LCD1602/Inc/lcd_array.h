@@ -0,0 +1,33 @@
+/*
+ * lcd_array.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef INC_LCD_ARRAY_H_
+#define INC_LCD_ARRAY_H_
+
+#include "lcd1602.h"
+
+#define LCD_ARRAY_SIZE 8 ///?> Наибольшее число дисплеев массива (+1 дескриптор в реестре на широковещание)
+
+/// Массив одинаковых дисплеев на общей шине данных (транспорт GPIO):
+/// D0-D7/D4-D7, RS и RW общие, у каждого дисплея свой строб E на одном порту.
+/// Отдельный дисплей адресуется через свой дескриптор (LCD_SetCursor и т.д.),
+/// весь массив -- через функции LCD_Array*
+typedef struct {
+	LCD_HandleTypeDef *Displays[LCD_ARRAY_SIZE]; ///?> Дисплеи (настройки заполняются до LCD_ArrayInit)
+	uint8_t            Count;                   ///?> Число дисплеев
+
+	LCD_HandleTypeDef  All;                     ///?> Широковещательный дескриптор: EPin -- стробы всех дисплеев
+} LCD_ArrayTypeDef;
+
+void LCD_ArrayInit       (LCD_ArrayTypeDef *harr);
+void LCD_ArraySetCursor  (LCD_ArrayTypeDef *harr, uint8_t row, uint8_t col);
+void LCD_ArraySendString (LCD_ArrayTypeDef *harr, char *str, uint8_t size);
+void LCD_ArrayFlush      (LCD_ArrayTypeDef *harr);
+void LCD_ArrayClear      (LCD_ArrayTypeDef *harr);
+
+#endif /* INC_LCD_ARRAY_H_ */
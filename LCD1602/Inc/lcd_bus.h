@@ -0,0 +1,37 @@
+/*
+ * lcd_bus.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef INC_LCD_BUS_H_
+#define INC_LCD_BUS_H_
+
+#include "lcd1602.h"
+
+#define LCD_BUS_SIZE        LCD_PCF8574T_INSTANCES ///?> Наибольшее число дисплеев на шине: по контекстам транспорта, не больше 16 (адреса PCF8574 и PCF8574A)
+#define LCD_BUS_BATCH_CELLS 16                     ///?> Наибольшее число ячеек в одном кадре дисплея
+#define LCD_BUS_RATE_MS     1000                   ///?> Окно подсчёта частоты обновления, мс
+
+/// Планировщик дисплеев PCF8574T на одной шине I2C (у каждой из шин
+/// I2C1-I2C3 свой, LCD_BusFlushAll обновляет их параллельно). Приложение пишет
+/// только в теневые буферы (LCD_SetCursor, LCD_SendString), изменения
+/// отправляет планировщик кадрами по очереди дисплеев (LCD_BusProcess)
+typedef struct {
+	LCD_HandleTypeDef *Displays[LCD_BUS_SIZE]; ///?> Дисплеи (настройки заполняются до LCD_BusInit, адреса 0x20-0x27, 0x38-0x3F)
+	uint8_t            Count;                  ///?> Число дисплеев
+
+	uint8_t            Next;                   ///?> Дисплей, с которого начнётся следующий обход
+	uint16_t           Refreshes[LCD_BUS_SIZE];///?> Законченных обновлений в текущем окне
+	uint16_t           Rate[LCD_BUS_SIZE];     ///?> Обновлений в секунду (последнее окно)
+	uint32_t           Window;                 ///?> Начало окна подсчёта (HAL_GetTick)
+} LCD_BusTypeDef;
+
+void     LCD_BusInit    (LCD_BusTypeDef *hbus);
+void     LCD_BusProcess (LCD_BusTypeDef *hbus);
+uint16_t LCD_BusRate    (LCD_BusTypeDef *hbus, uint8_t index);
+void     LCD_BusFlushAll(LCD_BusTypeDef *const *hbus, uint8_t count);
+
+#endif /* INC_LCD_BUS_H_ */
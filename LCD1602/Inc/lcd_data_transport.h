@@ -5,18 +5,26 @@
  *      Author: denis
  */
 #include <stdint.h>
+#include "lcd_timing.h"
 
 #ifndef INC_LCD_DATA_TRANSPORT_H_
 #define INC_LCD_DATA_TRANSPORT_H_
 
 #define START_STROB 1                   ///?> Строб для запуска чтения данных логическим анализатором
 
-#define LCD_DATA_WIDTH_8BIT           0 ///?> Ширина данных 8 бит (выбрать 1 из двух)
-#define LCD_DATA_WIDTH_4BIT           1 ///?> Ширина данных 4 бита (выбрать 1 из двух)
+#define LCD_DATA_WIDTH_8BIT           0 ///?> Ширина шины транспортов GPIO и 74HC595: 8 бит (выбрать 1 из двух)
+#define LCD_DATA_WIDTH_4BIT           1 ///?> Ширина шины транспортов GPIO и 74HC595: 4 бита (выбрать 1 из двух)
 
-#define LCD_DATA_TRANSPORT_GPIO       0 ///?> Транспортный протокол GPIO (прямая передача данных через GPIO-порты)
-#define LCD_DATA_TRANSPORT_74HC595    0 ///?> Транспортный протокол через 74HC595
-#define LCD_DATA_TRANSPORT_PCF8574T   1 ///?> Транспортный протокол через I2C PCF8574T
+#define LCD_DATA_TRANSPORT_GPIO       0 ///?> Собрать транспорт GPIO (прямая передача данных через GPIO-порты)
+#define LCD_DATA_TRANSPORT_74HC595    0 ///?> Собрать транспорт через 74HC595
+#define LCD_DATA_TRANSPORT_PCF8574T   1 ///?> Собрать транспорт через I2C PCF8574T (всегда 4 бита)
+#define LCD_DATA_TRANSPORT_FSMC       0 ///?> Собрать транспорт через FSMC (шина 8080, всегда 8 бит)
+
+#define LCD_MAX_DISPLAYS             12 ///?> Наибольшее число дисплеев (дескрипторов LCD_HandleTypeDef), не больше 16
+
+#define LCD_ENABLE_E1   0x01 ///?> Строб E (E1): первый контроллер модуля
+#define LCD_ENABLE_E2   0x02 ///?> Строб E2: второй контроллер модуля 40x4
+#define LCD_ENABLE_BOTH (LCD_ENABLE_E1 | LCD_ENABLE_E2) ///?> Оба контроллера одним циклом шины
 
 #define LCD_DATA_WIDTH_BYTE           1 ///?> Ширина данных 8 бит (байт)
 #define LCD_DATA_WIDTH_HALF_BYTE      2 ///?> Ширина данных 4 бита (полубайт)
@@ -30,23 +38,88 @@
 #define LCD_DATA_WIDTH LCD_DATA_WIDTH_HALF_BYTE
 #endif
 
-#define LCD_DATA_GPIO                1 ///?> Транспорт GPIO
-#define LCD_DATA_74HC595             2 ///?> Транспорт 74HC595
-#define LCD_DATA_PCF8574T            3 ///?> Транспорт PCF8574T
-
-#if LCD_DATA_TRANSPORT_GPIO != 0
-#undef  LCD_DATA_TRANSPORT
-#define LCD_DATA_TRANSPORT LCD_DATA_GPIO
-#elif LCD_DATA_TRANSPORT_74HC595 != 0
-#undef  LCD_DATA_TRANSPORT
-#define LCD_DATA_TRANSPORT LCD_DATA_74HC595
-#elif LCD_DATA_TRANSPORT_PCF8574T != 0
-#undef  LCD_DATA_TRANSPORT
-#define LCD_DATA_TRANSPORT LCD_DATA_PCF8574T
-#endif
+#define LCD_GPIO_PORTS(X) X(GPIOA) X(GPIOB) X(GPIOC) X(GPIOD) X(GPIOE) ///?> Транспорт GPIO: порты, на которых могут быть пины дисплея (*_GPIO_Port из main.h)
+#define LCD_GPIO_BUSY_FLAG          1 ///?> Транспорт GPIO: ожидать сброса флага занятости (BF) по линии RW вместо фиксированной задержки
+#define LCD_GPIO_BENCHMARK          0 ///?> Транспорт GPIO: собрать LCD_GpioBenchmark (такты DWT на кодирование слова BSRR)
+#define LCD_BUSY_TIMEOUT_MS         5 ///?> Предельное время ожидания сброса флага занятости, мс
+
+#define LCD_ASYNC_MODE              0   ///?> Асинхронный режим: команды ставятся в очередь и отправляются по прерыванию TIM7
+#define LCD_ASYNC_QUEUE_SIZE        128 ///?> Размер очереди асинхронного режима (степень двойки)
+#define LCD_ASYNC_IRQ_PRIORITY      15  ///?> Приоритет прерывания TIM7
+
+#define LCD_GPIO_DMA                0    ///?> Транспорт GPIO: кадр выводится в GPIOD->BSRR через DMA2 по событию обновления TIM1
+#define LCD_GPIO_DMA_TICK_NS        1000 ///?> Такт вывода слов BSRR, нс (не меньше PWEH)
+#define LCD_GPIO_DMA_FRAME_WORDS    2048 ///?> Размер буфера кадра, слов BSRR
+#define LCD_GPIO_DMA_IRQ_PRIORITY   15   ///?> Приоритет прерывания DMA2 Stream5
+
+#define LCD_74HC595_SPI             0    ///?> Транспорт 74HC595: сдвиг через SPI2 (SRCLK -- PB13, SER -- PB15) вместо программного
+#define LCD_74HC595_SPI_BR          1    ///?> Делитель SPI2: PCLK1 / 2^(BR+1) (1 -- 6.25 МГц при PCLK1 25 МГц: SYSCLK 100 МГц / 4)
+#define LCD_74HC595_DMA             0    ///?> Транспорт 74HC595: кадр выводится в SPI2 через DMA1 по TIM4, RCLK -- TIM4_CH1 (PD12)
+#define LCD_74HC595_DMA_TICK_NS     1000 ///?> Такт вывода байт кадра, нс (не меньше сдвига байта и PWEH)
+#define LCD_74HC595_FRAME_SIZE      2048 ///?> Размер буфера кадра, байт (в 8-битном режиме -- слов по 16 бит)
+#define LCD_74HC595_DMA_IRQ_PRIORITY 15  ///?> Приоритет прерывания DMA1 Stream6
+
+#define LCD_PCF8574T_INSTANCES      4    ///?> Транспорт PCF8574T: число дисплеев (буферов кадра), на одной шине до 16 (0x20-0x27, 0x38-0x3F). Контекст ~280 байт (с DMA ~536 и 48 байт очередей шин), для 16 модулей -- ~4.5 КБ (с DMA ~9.3 КБ) и LCD_MAX_DISPLAYS 16
+#define LCD_PCF8574T_FRAME_SIZE     256  ///?> Транспорт PCF8574T: размер кадра одной транзакции I2C, байт (4 байта на символ)
+#define LCD_PCF8574T_DMA            0    ///?> Транспорт PCF8574T: кадры дисплеев передаются через DMA1 (I2C1 -- Stream6, I2C2 -- Stream7, I2C3 -- Stream4), двойной буфер; HAL-обработчики I2C вызывают LCD_I2cTxCplt/LCD_I2cError
+#define LCD_PCF8574T_DMA_IRQ_PRIORITY 15 ///?> Приоритет прерываний DMA1 Stream6/7/4 и I2C1/I2C2/I2C3
+#define LCD_FSMC_DMA                0    ///?> Транспорт FSMC: строки данных кадра выводятся через DMA2 по TIM1
+#define LCD_FSMC_FRAME_SIZE         128  ///?> Размер буфера данных кадра, байт
+#define LCD_FSMC_FRAME_SEGMENTS     16   ///?> Число отрезков (команда + строка данных) в кадре
+#define LCD_FSMC_DMA_IRQ_PRIORITY   15   ///?> Приоритет прерываний DMA2 Stream5 и TIM1
+
+typedef struct __LCD_HandleTypeDef LCD_HandleTypeDef; ///?> Дескриптор дисплея (lcd1602.h)
+
+/// Операции транспорта. Таблица одна на вид транспорта и общая
+/// для всех его дисплеев, состояние каждого дисплея -- в дескрипторе.
+/// Пустой указатель кадровой операции -- инструкция отправляется сразу.
+/// Стробируются контроллеры из LCD_HandleTypeDef::Enable
+typedef struct {
+	uint8_t Width;                                                   ///?> Ширина шины: LCD_DATA_WIDTH_BYTE / LCD_DATA_WIDTH_HALF_BYTE
+	void    (*Init)         (LCD_HandleTypeDef *hlcd);                ///?> Инициализация транспорта дисплея
+	void    (*SendCommand)  (LCD_HandleTypeDef *hlcd, uint8_t cmd);   ///?> Отправка команды (RS = 0) без ожидания выполнения
+	void    (*SendData)     (LCD_HandleTypeDef *hlcd, uint8_t data);  ///?> Отправка данных (RS = 1) без ожидания выполнения
+	void    (*WaitReady)    (LCD_HandleTypeDef *hlcd, uint8_t enable);  ///?> Ожидание готовности контроллеров enable, NULL -- по таблице времён
+	void    (*FrameBegin)   (LCD_HandleTypeDef *hlcd);                ///?> Начало кадра
+	void    (*FrameCommand) (LCD_HandleTypeDef *hlcd, uint8_t cmd);   ///?> Команда в кадр
+	void    (*FrameData)    (LCD_HandleTypeDef *hlcd, uint8_t data);  ///?> Данные в кадр
+	void    (*FrameEnd)     (LCD_HandleTypeDef *hlcd);                ///?> Запуск вывода кадра
+	uint8_t (*FrameBusy)    (LCD_HandleTypeDef *hlcd);                ///?> Следующий кадр будет ждать вывода предыдущих
+	uint32_t (*ByteTimeNs)  (LCD_HandleTypeDef *hlcd);                ///?> Время передачи байта дисплею, нс (модель стоимости), NULL -- по циклу E
+} LCD_TransportTypeDef;
+
+extern const LCD_TransportTypeDef LCD_TransportGpio;     ///?> Транспорт GPIO (LCD_DATA_TRANSPORT_GPIO)
+extern const LCD_TransportTypeDef LCD_Transport74HC595;  ///?> Транспорт 74HC595 (LCD_DATA_TRANSPORT_74HC595)
+extern const LCD_TransportTypeDef LCD_TransportPCF8574T; ///?> Транспорт PCF8574T (LCD_DATA_TRANSPORT_PCF8574T)
+extern const LCD_TransportTypeDef LCD_TransportFSMC;     ///?> Транспорт FSMC (LCD_DATA_TRANSPORT_FSMC)
+
+void    LCD_TransportInit   (LCD_HandleTypeDef *hlcd);
+void    LCD_TransportLost   (LCD_HandleTypeDef *hlcd);
+void    LCD_SelectController(LCD_HandleTypeDef *hlcd, uint8_t enable);
+void    LCD_WaitReady       (LCD_HandleTypeDef *hlcd, uint8_t enable);
+void    LCD_SendCommand     (LCD_HandleTypeDef *hlcd, uint8_t cmd);
+void    LCD_SendData        (LCD_HandleTypeDef *hlcd, uint8_t data);
+void    LCD_WaitMs          (uint32_t ms);
+uint8_t LCD_IsBusy          (void);
+void    LCD_AsyncIRQHandler (void);
 
-void LCD_TransportInit (void);
-void LCD_SendCommand   (uint8_t cmd);
-void LCD_SendData      (uint8_t data);
+void    LCD_FrameBegin      (LCD_HandleTypeDef *hlcd);
+void    LCD_FrameCommand    (LCD_HandleTypeDef *hlcd, uint8_t cmd);
+void    LCD_FrameData       (LCD_HandleTypeDef *hlcd, uint8_t data);
+void    LCD_FrameEnd        (LCD_HandleTypeDef *hlcd);
+uint8_t LCD_FrameBusy       (LCD_HandleTypeDef *hlcd);
+uint32_t LCD_ByteTimeNs     (LCD_HandleTypeDef *hlcd);
+void    LCD_FrameCompleteCallback (LCD_HandleTypeDef *hlcd);
+void    LCD_GpioDmaIRQHandler     (void);
+void    LCD_GpioBenchmark         (uint32_t *lut, uint32_t *calc);
+void    LCD_SpiDmaIRQHandler      (void);
+void    LCD_FsmcDmaIRQHandler     (void);
+void    LCD_FsmcTimIRQHandler     (void);
+void    LCD_I2cDmaIRQHandler      (I2C_TypeDef *instance);
+void    LCD_I2cEvIRQHandler       (I2C_TypeDef *instance);
+void    LCD_I2cErIRQHandler       (I2C_TypeDef *instance);
+void    LCD_I2cTxCplt             (I2C_HandleTypeDef *hi2c);
+void    LCD_I2cError              (I2C_HandleTypeDef *hi2c);
+uint8_t LCD_I2cBusy               (I2C_HandleTypeDef *hi2c);
 
 #endif /* INC_LCD_DATA_TRANSPORT_H_ */
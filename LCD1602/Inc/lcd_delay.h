@@ -0,0 +1,19 @@
+/*
+ * lcd_delay.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef INC_LCD_DELAY_H_
+#define INC_LCD_DELAY_H_
+
+void LCD_DelayInit   (void);
+void LCD_DelayCycles (uint32_t cycles);
+void LCD_DelayNs     (uint32_t ns);
+void LCD_DelayUs     (uint32_t us);
+uint32_t LCD_DelayStamp (void);
+void     LCD_DelaySince (uint32_t start, uint32_t us);
+
+#endif /* INC_LCD_DELAY_H_ */
@@ -0,0 +1,43 @@
+/*
+ * lcd_glyph.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef INC_LCD_GLYPH_H_
+#define INC_LCD_GLYPH_H_
+
+#include "lcd1602.h"
+
+#define LCD_GLYPH_SLOTS 8      ///?> Ячеек CGRAM под знаки 5x8
+#define LCD_GLYPH_ROWS  8      ///?> Строк растра знака (байт на знак)
+#define LCD_GLYPH_CODE  0x08   ///?> Код ячейки 0 в DDRAM: 0x08-0x0F -- зеркало 0x00-0x07, без NUL в строках
+#define LCD_GLYPH_NONE  0xFFFF ///?> Ячейка CGRAM свободна
+
+/// Кэш пользовательских знаков: логические знаки приложения (иконки,
+/// недостающие в ROM A00 буквы, сегменты шкал) в 8 ячейках CGRAM.
+/// Знак загружается только при промахе, вытесняется давно не
+/// использованный знак, которого нет в теневом буфере
+typedef struct {
+	LCD_HandleTypeDef *Display;                        ///?> Дисплей (после LCD_Init)
+	const uint8_t    (*Bitmaps)[LCD_GLYPH_ROWS];       ///?> Таблица растров приложения, индекс -- ID знака
+	uint16_t           Count;                          ///?> Число знаков в таблице
+
+	uint16_t           Slot[LCD_GLYPH_SLOTS];          ///?> ID знака в ячейке CGRAM, LCD_GLYPH_NONE -- свободна
+	uint32_t           Used[LCD_GLYPH_SLOTS];          ///?> Последнее обращение к ячейке (Tick)
+	uint8_t            Refs[LCD_GLYPH_SLOTS];          ///?> Ячеек теневого буфера со знаком (пересчёт при промахе)
+	uint8_t            Upload;                         ///?> Маска ячеек CGRAM, ждущих загрузки
+	uint32_t           Tick;                           ///?> Счётчик обращений
+	uint32_t           Hits;                           ///?> Попаданий
+	uint32_t           Misses;                         ///?> Промахов (загрузок)
+} LCD_GlyphCacheTypeDef;
+
+void    LCD_GlyphInit  (LCD_GlyphCacheTypeDef *hgc, LCD_HandleTypeDef *hlcd,
+                        const uint8_t (*bitmaps)[LCD_GLYPH_ROWS], uint16_t count);
+uint8_t LCD_GlyphPut   (LCD_GlyphCacheTypeDef *hgc, uint16_t id);
+void    LCD_GlyphFlush (LCD_GlyphCacheTypeDef *hgc);
+void    LCD_GlyphStats (LCD_GlyphCacheTypeDef *hgc, uint32_t *hits, uint32_t *misses);
+
+#endif /* INC_LCD_GLYPH_H_ */
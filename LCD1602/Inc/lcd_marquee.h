@@ -0,0 +1,34 @@
+/*
+ * lcd_marquee.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef INC_LCD_MARQUEE_H_
+#define INC_LCD_MARQUEE_H_
+
+#include "lcd1602.h"
+
+#define LCD_MARQUEE_LEN 40 ///?> Длина кольцевого текста строки (строка DDRAM двухстрочного режима)
+
+/// Бегущие строки дисплея. Текст строки (до 40 символов) загружается
+/// в её строку DDRAM целиком один раз, шаг прокрутки -- одна команда
+/// сдвига изображения (0x18/0x1C), если прокручиваются все строки
+/// дисплея вместе. Иначе видимые ячейки строки переписываются через
+/// теневой буфер (отправляются LCD_Flush)
+typedef struct {
+	LCD_HandleTypeDef *Display;                          ///?> Дисплей (после LCD_Init)
+	uint8_t            Text[LCD_ROWS][LCD_MARQUEE_LEN]; ///?> Кольцевой текст строк, дополненный пробелами
+	uint8_t            Offset[LCD_ROWS];                ///?> Символ текста в первой видимой колонке
+	uint8_t            Active;                          ///?> Маска бегущих строк
+	uint8_t            Loaded;                          ///?> Маска строк, строка DDRAM которых целиком хранит кольцевой текст
+} LCD_MarqueeTypeDef;
+
+void LCD_MarqueeInit    (LCD_MarqueeTypeDef *hmq, LCD_HandleTypeDef *hlcd);
+void LCD_MarqueeSetText (LCD_MarqueeTypeDef *hmq, uint8_t row, char *str, uint8_t size);
+void LCD_MarqueeStop    (LCD_MarqueeTypeDef *hmq, uint8_t row);
+void LCD_MarqueeStep    (LCD_MarqueeTypeDef *hmq, uint8_t rows, uint8_t left);
+
+#endif /* INC_LCD_MARQUEE_H_ */
@@ -0,0 +1,28 @@
+/*
+ * lcd_page.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef INC_LCD_PAGE_H_
+#define INC_LCD_PAGE_H_
+
+#include "lcd1602.h"
+
+/// Две страницы в строках DDRAM дисплея (16x2, 20x2): видимая --
+/// с колонки 0, невидимая -- с колонки 40 - Cols. Следующий экран
+/// пишется в теневой буфер как обычно, LCD_PageFlip отправляет его
+/// в невидимую страницу и переключает страницы сдвигом изображения
+typedef struct {
+	LCD_HandleTypeDef *Display;                             ///?> Дисплей (после LCD_Init)
+	uint8_t            Page[2][LCD_ROWS][LCD_COLS];        ///?> Содержимое страниц DDRAM
+	uint8_t            Stale[2][LCD_ROWS][LCD_DIRTY_BYTES];///?> Ячейки страниц с неизвестным содержимым
+	uint8_t            Shown;                              ///?> Видимая страница
+} LCD_PageTypeDef;
+
+void LCD_PageInit (LCD_PageTypeDef *hpg, LCD_HandleTypeDef *hlcd);
+void LCD_PageFlip (LCD_PageTypeDef *hpg);
+
+#endif /* INC_LCD_PAGE_H_ */
@@ -0,0 +1,46 @@
+/*
+ * lcd_timing.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef INC_LCD_TIMING_H_
+#define INC_LCD_TIMING_H_
+
+#define LCD_CONTROLLER_HD44780   1 ///?> Hitachi HD44780
+#define LCD_CONTROLLER_ST7066U   2 ///?> Sitronix ST7066U
+#define LCD_CONTROLLER_SPLC780D  3 ///?> Sunplus SPLC780D
+#define LCD_CONTROLLER_KS0066    4 ///?> Samsung KS0066U
+
+#ifndef LCD_CONTROLLER // Проверка на ПК (Test) собирает все профили
+#define LCD_CONTROLLER    LCD_CONTROLLER_HD44780 ///?> Контроллер дисплея (выбор профиля времён выполнения)
+#endif
+#define LCD_TIMING_MARGIN 25                     ///?> Запас к времени выполнения инструкции по спецификации, %
+#define LCD_TIMING_FOSC_MIN_KHZ 250              ///?> Самая низкая частота генератора контроллера, которую должен покрыть запас, КГц
+
+/// Временные параметры шины HD44780 (спецификация, запись/чтение)
+#define LCD_T_AS_NS    60   ///?> Установка RS/RW до фронта E (tAS)
+#define LCD_T_PWEH_NS  450  ///?> Длительность импульса E (PWEH), не меньше задержки данных чтения tDDR
+#define LCD_T_CYCE_NS  1000 ///?> Период цикла E (tcycE)
+
+/// Классы инструкций контроллера. Номер класса команды совпадает
+/// с номером старшего взведённого бита кода команды
+typedef enum {
+	LCD_INSTR_CLEAR = 0,       ///?> Очистка экрана (0b00000001)
+	LCD_INSTR_HOME,            ///?> Возврат курсора в начало (0b0000001*)
+	LCD_INSTR_ENTRY_MODE,      ///?> Настройка ввода (0b000001**)
+	LCD_INSTR_DISPLAY_CONTROL, ///?> Режим дисплея (0b00001***)
+	LCD_INSTR_SHIFT,           ///?> Сдвиг курсора/экрана (0b0001****)
+	LCD_INSTR_FUNCTION_SET,    ///?> Функции: битность, строки, шрифт (0b001*****)
+	LCD_INSTR_CGRAM_ADDRESS,   ///?> Установка адреса CGRAM (0b01******)
+	LCD_INSTR_DDRAM_ADDRESS,   ///?> Установка адреса DDRAM (0b1*******)
+	LCD_INSTR_DATA,            ///?> Запись данных в CGRAM/DDRAM (RS = 1)
+	LCD_INSTR_COUNT            ///?> Количество классов
+} LCD_InstrClass;
+
+LCD_InstrClass LCD_InstrClassify (uint8_t cmd);
+uint32_t       LCD_InstrTimeUs   (LCD_InstrClass instr);
+
+#endif /* INC_LCD_TIMING_H_ */
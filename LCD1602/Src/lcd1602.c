@@ -4,66 +4,432 @@
  *  Created on: Nov 29, 2024
  *      Author: denis
  */
-#include "main.h"
 #include "lcd1602.h"
-#include "lcd_data_transport.h"
 
+#include <string.h>
 
-/** @brief Позиционирует курсор
- *  @details рассчитано на 2 строки
+#define LCD_LINE2_ADDR  0x40                 ///?> Адрес DDRAM второй строки контроллера
+#define LCD_DISPLAY_CONTROL 0b00001000      ///?> Display On/Off Control
+#define LCD_DISPLAY_ON      0b00000100      ///?> D: изображение включено
+#define LCD_CURSOR_ON       0b00000010      ///?> C: курсор-подчёркивание
+#define LCD_BLINK_ON        0b00000001      ///?> B: мигание знакоместа
+#define LCD_ENTRY_MODE      0b00000100      ///?> Entry Mode Set
+#define LCD_ENTRY_INC       0b00000010      ///?> I/D: AC++ после записи
+#define LCD_ENTRY_SHIFT     0b00000001      ///?> S: сдвиг изображения после записи
+
+#if (LCD_ROWS > 4)
+#error "LCD_ROWS не больше 4 (таблица LCD_GeometryTypeDef::RowOffset)"
+#endif
+
+const LCD_GeometryTypeDef LCD_Geometry16x1      = { 1, 16, 1, 0, { 0x00 },                   0 };
+const LCD_GeometryTypeDef LCD_Geometry16x1Split = { 1, 16, 2, 8, { 0x00 },                   0 };
+const LCD_GeometryTypeDef LCD_Geometry16x2      = { 2, 16, 2, 0, { 0x00, 0x40 },             0 };
+const LCD_GeometryTypeDef LCD_Geometry16x4      = { 4, 16, 2, 0, { 0x00, 0x40, 0x10, 0x50 }, 0 };
+const LCD_GeometryTypeDef LCD_Geometry20x2      = { 2, 20, 2, 0, { 0x00, 0x40 },             0 };
+const LCD_GeometryTypeDef LCD_Geometry20x4      = { 4, 20, 2, 0, { 0x00, 0x40, 0x14, 0x54 }, 0 };
+const LCD_GeometryTypeDef LCD_Geometry40x2      = { 2, 40, 2, 0, { 0x00, 0x40 },             0 };
+const LCD_GeometryTypeDef LCD_Geometry40x4      = { 4, 40, 2, 0, { 0x00, 0x40, 0x00, 0x40 }, 2 };
+
+/** @brief Маска всех контроллеров дисплея
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return LCD_ENABLE_BOTH для 40x4, иначе LCD_ENABLE_E1
+ */
+static inline uint8_t s_all (LCD_HandleTypeDef *hlcd)
+{
+	return hlcd->Geometry->E2Row ? LCD_ENABLE_BOTH : LCD_ENABLE_E1;
+}
+
+/** @brief Возвращает адрес DDRAM ячейки
+ *  @details
+ *  	Адрес начала строки берётся из таблицы геометрии дисплея,
+ *  	координаты проверены вызывающим. При сдвинутом изображении
+ *  	(LCD_HandleTypeDef::Shift) видимой ячейке соответствует
+ *  	адрес дальше по кольцевой строке DDRAM
+ *  @param [in] hlcd дескриптор дисплея
  *  @param [in] row № строки (начинается с 0)
  *  @param [in] col № колонки (начинается с 0)
+ *  @return адрес DDRAM
  */
-void LCD_SetCursor(uint8_t row, uint8_t col) {
-    uint8_t address;
+static inline uint8_t s_ddram_address (LCD_HandleTypeDef *hlcd, uint8_t row, uint8_t col)
+{
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
+	uint8_t address = geo->RowOffset[row];
+	if (geo->SplitCol && col >= geo->SplitCol)
+	{
+		address += LCD_LINE2_ADDR;
+		col     -= geo->SplitCol;
+	}
+	if (geo->Lines != 2)
+		return (uint8_t) ((address + col + hlcd->Shift) % 80);
+	uint8_t line = address & LCD_LINE2_ADDR;
+	return (uint8_t) (line + (address - line + col + hlcd->Shift) % 40);
+}
 
-    // Определяем адрес DDRAM
-    if (row == 0) {
-        address = 0x00 + col;  // Первая строка
-    } else if (row == 1) {
-        address = 0x40 + col;  // Вторая строка
-    }
+/** @brief Сбрасывает теневой буфер в пробелы
+ *  @note
+ *  	Вызывается после аппаратной очистки дисплея, поэтому
+ *  	битовая карта изменений тоже сбрасывается
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_reset (LCD_HandleTypeDef *hlcd)
+{
+	memset(hlcd->Frame, ' ', sizeof(hlcd->Frame));
+	memset(hlcd->Dirty, 0, sizeof(hlcd->Dirty));
+	memset(hlcd->Blank, 0, sizeof(hlcd->Blank));
+	hlcd->Row = 0;
+	hlcd->Col = 0;
+}
 
-    // Отправляем команду установки адреса DDRAM
-    LCD_SendCommand(0x80 | address);
+/** @brief Позиционирует курсор теневого буфера
+ *  @details
+ *  	Команда в дисплей не отправляется. Адрес DDRAM
+ *  	устанавливается в LCD_Flush только там, где прерывается
+ *  	последовательность изменённых ячеек
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] row № строки (начинается с 0)
+ *  @param [in] col № колонки (начинается с 0)
+ */
+void LCD_SetCursor(LCD_HandleTypeDef *hlcd, uint8_t row, uint8_t col) {
+	if (row >= hlcd->Geometry->Rows || col >= hlcd->Geometry->Cols)
+		return;
+	hlcd->Row = row;
+	hlcd->Col = col;
 }
 
-/** @brief Отправляет строку
+/** @brief Записывает строку в теневой буфер
+ *  @note
+ *  	Ячейка помечается изменённой, только если символ отличается
+ *  	от уже записанного (у стёртой LCD_SoftClear -- от символа на экране). Строка переносится на начало следующей
+ *  	строки дисплея и обрезается по концу последней.
+ *  	Для вывода на дисплей нужно вызвать LCD_Flush
+ *  @param [in] hlcd дескриптор дисплея
  *  @param [in] str указатель на строку
  *  @param [in] size размер строки в байтах
  *  @return None
  */
-void LCD_SendString(char *str, uint8_t size)
+void LCD_SendString(LCD_HandleTypeDef *hlcd, char *str, uint8_t size)
 {
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
 	uint8_t cnt = 0;
-	while(*str && cnt < size)
+	while(*str && cnt < size && hlcd->Row < geo->Rows)
 	{
-		LCD_SendData(*str++);
+		uint8_t row = hlcd->Row;
+		uint8_t col = hlcd->Col;
+		uint8_t bit = (uint8_t) (1 << (col & 0x07));
+		if (hlcd->Blank[row][col >> 3] & bit)
+		{
+			hlcd->Blank[row][col >> 3] &= (uint8_t) ~bit;
+			if (hlcd->Frame[row][col] == (uint8_t) *str)
+				hlcd->Dirty[row][col >> 3] &= (uint8_t) ~bit; // На экране уже этот символ
+		}
+		if (hlcd->Frame[row][col] != (uint8_t) *str)
+		{
+			hlcd->Frame[row][col] = (uint8_t) *str;
+			hlcd->Dirty[row][col >> 3] |= bit;
+		}
+		str ++;
 		cnt ++;
+		if (++ hlcd->Col >= geo->Cols)
+		{
+			if (row + 1 >= geo->Rows)
+			{
+				hlcd->Col = geo->Cols - 1; // Конец экрана, курсор остаётся на последней ячейке
+				break;
+			}
+			hlcd->Row ++;
+			hlcd->Col = 0;
+		}
 	}
 }
 
-#if LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE
-/** @brief Инициализация дисплея в 8битном режиме
+/** @brief Ищет следующую изменённую ячейку
+ *  @param [in]     hlcd дескриптор дисплея
+ *  @param [in,out] row  № строки, с которой начинается поиск
+ *  @param [in,out] col  № колонки, с которой начинается поиск
+ *  @param [in]     end  строка, на которой поиск прекращается
+ *  @return 1 -- ячейка найдена (row, col), 0 -- изменений до end нет
+ */
+static uint8_t s_next_dirty (LCD_HandleTypeDef *hlcd, uint8_t *row, uint8_t *col, uint8_t end)
+{
+	for (; *row < end; (*row) ++, *col = 0)
+	{
+		for (; *col < hlcd->Geometry->Cols; (*col) ++)
+		{
+			if (hlcd->Dirty[*row][*col >> 3] & (1 << (*col & 0x07)))
+				return 1;
+		}
+	}
+	return 0;
+}
+
+/** @brief Время вывода ячеек по модели стоимости транспорта
+ *  @note
+ *  	Каждая инструкция -- передача байта (LCD_ByteTimeNs) и её
+ *  	выполнение контроллером (LCD_InstrTimeUs). Участок -- одна
+ *  	команда установки адреса DDRAM
+ *  @param [in] hlcd  дескриптор дисплея
+ *  @param [in] cells число ячеек
+ *  @param [in] runs  число непрерывных участков
+ *  @return время, нс
+ */
+static uint32_t s_cost_ns (LCD_HandleTypeDef *hlcd, uint16_t cells, uint16_t runs)
+{
+	uint32_t byte_ns = LCD_ByteTimeNs(hlcd);
+	return cells * (byte_ns + LCD_InstrTimeUs(LCD_INSTR_DATA) * 1000U) +
+	       runs  * (byte_ns + LCD_InstrTimeUs(LCD_INSTR_DDRAM_ADDRESS) * 1000U);
+}
+
+/** @brief Заменяет перезапись изменённых ячеек аппаратной очисткой, если это дешевле
+ *  @note
+ *  	Стёртые LCD_SoftClear ячейки сначала становятся пробелами.
+ *  	Без очистки пишутся изменённые ячейки. С очисткой --
+ *  	команда 0x01 (самая долгая инструкция) и все непустые
+ *  	ячейки теневого буфера: пробелы очистка уже поставила.
+ *  	Выбирается меньшее время по модели s_cost_ns
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
  */
-static void s_lcd_init_8bit (void)
+static void s_clear_if_cheaper (LCD_HandleTypeDef *hlcd)
 {
-	HAL_Delay(15); 				   // Задержка после подачи питания
-	LCD_SendCommand(0b00110000);   // 8ми битный интерфейс
-	HAL_Delay(5);
-	LCD_SendCommand(0b00110000);   // 8ми битный интерфейс
-	HAL_Delay(1);
-	LCD_SendCommand(0b00111000);   // 8ми битный интерфейс, две строки
-	HAL_Delay(1);
-	LCD_SendCommand(0b00001000);   // Display Off
-	LCD_SendCommand(0b00000010);   // установка курсора в начале строки
-	LCD_SendCommand(0b00001100);   // нормальный режим работы, выкл курсор
-	LCD_SendCommand(0b00000001);   // очистка дисплея
-	LCD_SendCommand(0b00000010);   // режим ввода
-	HAL_Delay(10);
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
+	uint16_t dirty = 0, dirty_runs = 0; // Изменённые ячейки
+	uint16_t text  = 0, text_runs  = 0; // Непустые ячейки
+	for (uint8_t row = 0; row < geo->Rows; row ++)
+	{
+		uint8_t in_dirty = 0, in_text = 0;
+		for (uint8_t col = 0; col < geo->Cols; col ++)
+		{
+			if (hlcd->Blank[row][col >> 3] & (1 << (col & 0x07)))
+				hlcd->Frame[row][col] = ' ';
+			uint8_t d = (hlcd->Dirty[row][col >> 3] >> (col & 0x07)) & 1;
+			uint8_t t = (hlcd->Frame[row][col] != ' ');
+			dirty      += d;
+			dirty_runs += d & !in_dirty;
+			text       += t;
+			text_runs  += t & !in_text;
+			in_dirty = d;
+			in_text  = t;
+		}
+	}
+	memset(hlcd->Blank, 0, sizeof(hlcd->Blank));
+	if (dirty <= text)
+		return; // Очистка не уменьшит число записей
+	uint32_t clear_ns = LCD_ByteTimeNs(hlcd) + LCD_InstrTimeUs(LCD_INSTR_CLEAR) * 1000U;
+	if (clear_ns + s_cost_ns(hlcd, text, text_runs) >= s_cost_ns(hlcd, dirty, dirty_runs))
+		return;
+	LCD_SendCommand(hlcd, 0b00000001);
+	for (uint8_t row = 0; row < geo->Rows; row ++)
+	{
+		memset(hlcd->Dirty[row], 0, sizeof(hlcd->Dirty[row]));
+		for (uint8_t col = 0; col < geo->Cols; col ++)
+		{
+			if (hlcd->Frame[row][col] != ' ')
+				hlcd->Dirty[row][col >> 3] |= (uint8_t) (1 << (col & 0x07));
+		}
+	}
+}
+
+/// Позиция отправки изменённых ячеек одного контроллера
+typedef struct {
+	LCD_HandleTypeDef *hlcd;    ///?> Дисплей, NULL -- изменений больше нет
+	uint8_t            enable;  ///?> Контроллер дисплея (LCD_ENABLE_E1/E2)
+	uint8_t            row;     ///?> Позиция поиска изменённой ячейки
+	uint8_t            col;
+	uint8_t            end;     ///?> Строка за концом половины контроллера
+} flush_channel_t;
+
+/** @brief Заполняет позиции отправки контроллеров дисплея
+ *  @param [in]  hlcd дескриптор дисплея
+ *  @param [out] ch   позиции (две для 40x4, иначе одна)
+ *  @return число заполненных позиций
+ */
+static uint8_t s_flush_channels (LCD_HandleTypeDef *hlcd, flush_channel_t *ch)
+{
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
+	ch[0] = (flush_channel_t) { hlcd, LCD_ENABLE_E1, 0, 0, geo->E2Row ? geo->E2Row : geo->Rows };
+	if (geo->E2Row == 0)
+		return 1;
+	ch[1] = (flush_channel_t) { hlcd, LCD_ENABLE_E2, geo->E2Row, 0, geo->Rows };
+	return 2;
 }
 
-#elif LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE
+/** @brief Отправляет изменённые ячейки, по одной на контроллер по кругу
+ *  @note
+ *  	Пока один контроллер выполняет запись символа, шина занята
+ *  	другими: ожидание выполнения отложенное (lcd_data_transport.c),
+ *  	поэтому время выполнения каждого прячется за записью остальных.
+ *  	Команда установки адреса отправляется, только если счётчик
+ *  	адреса контроллера (LCD_HandleTypeDef::Counter, ведёт
+ *  	lcd_data_transport.c) стоит не на нужной ячейке
+ *  @param [in] ch    позиции отправки
+ *  @param [in] count число позиций
+ *  @param [in] cells наибольшее число отправляемых ячеек
+ *  @return None
+ */
+static void s_flush_round_robin (flush_channel_t *ch, uint8_t count, uint16_t cells)
+{
+	uint8_t left = count; // Позиции, у которых ещё есть изменения
+	uint8_t k = 0;
+	while (left && cells)
+	{
+		flush_channel_t *c = &ch[k];
+		if (++ k >= count)
+			k = 0;
+		if (c->hlcd == NULL)
+			continue;
+		LCD_HandleTypeDef *hlcd = c->hlcd;
+		if (!s_next_dirty(hlcd, &c->row, &c->col, c->end))
+		{
+			c->hlcd = NULL;
+			left --;
+			continue;
+		}
+		if (hlcd->Geometry->E2Row)
+			LCD_SelectController(hlcd, c->enable);
+		uint8_t address = s_ddram_address(hlcd, c->row, c->col);
+		if (hlcd->Counter[c->enable >> 1] != address)
+			LCD_FrameCommand(hlcd, 0x80 | address);
+		LCD_FrameData(hlcd, hlcd->Frame[c->row][c->col]);
+		hlcd->Dirty[c->row][c->col >> 3] &= (uint8_t) ~(1 << (c->col & 0x07));
+		c->col ++;
+		cells --;
+	}
+}
+
+/** @brief Отправляет в дисплей изменённые ячейки теневого буфера
+ *  @note
+ *  	Изменённые ячейки отправляются непрерывными участками.
+ *  	Адрес DDRAM контроллера после записи символа увеличивается сам,
+ *  	поэтому команда установки адреса отправляется только в начале
+ *  	участка, если контроллер не стоит уже на нужном адресе
+ *  	(в том числе после прошлого LCD_Flush и при переходе
+ *  	0x27 -> 0x40 между строками контроллера).
+ *  	У дисплея 40x4 ячейки верхней и нижней половины отправляются
+ *  	поочерёдно (s_flush_round_robin).
+ *  	Участки собираются в кадр (LCD_FrameBegin/LCD_FrameEnd), который
+ *  	транспорт может вывести в фоне. Если по модели стоимости
+ *  	транспорта аппаратная очистка с записью непустых ячеек быстрее,
+ *  	сначала отправляется она (s_clear_if_cheaper)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+void LCD_Flush(LCD_HandleTypeDef *hlcd)
+{
+	LCD_FlushAll(&hlcd, 1);
+}
+
+/** @brief Отправляет изменённые ячейки нескольких дисплеев
+ *  @note
+ *  	Дисплеи на общей шине данных (свой строб E у каждого)
+ *  	пишутся вперемежку, по ячейке на дисплей, поэтому время
+ *  	обновления почти не растёт с их числом.
+ *  	Кадры разных дисплеев не перемежаются (буфер кадра транспорта
+ *  	один), поэтому дисплеи, транспорт которых выводит кадры,
+ *  	обновляются по очереди целиком
+ *  @param [in] hlcd  массив дескрипторов дисплеев
+ *  @param [in] count число дисплеев (не больше LCD_MAX_DISPLAYS)
+ *  @return None
+ */
+void LCD_FlushAll (LCD_HandleTypeDef *const *hlcd, uint8_t count)
+{
+	flush_channel_t ch[2 * LCD_MAX_DISPLAYS];
+	uint8_t framed[LCD_MAX_DISPLAYS]; // Дисплей обновляется своим кадром
+	uint8_t n = 0;
+	if (count > LCD_MAX_DISPLAYS)
+		count = LCD_MAX_DISPLAYS;
+	for (uint8_t i = 0; i < count; i ++)
+	{
+		s_clear_if_cheaper(hlcd[i]);
+		framed[i] = (count > 1 && hlcd[i]->Transport->FrameBegin != NULL);
+		if (framed[i])
+			continue;
+		LCD_FrameBegin(hlcd[i]);
+		n += s_flush_channels(hlcd[i], &ch[n]);
+	}
+	s_flush_round_robin(ch, n, UINT16_MAX);
+	for (uint8_t i = 0; i < count; i ++)
+	{
+		if (framed[i])
+		{
+			flush_channel_t one[2];
+			LCD_FrameBegin(hlcd[i]);
+			s_flush_round_robin(one, s_flush_channels(hlcd[i], one), UINT16_MAX);
+		}
+		LCD_SelectController(hlcd[i], s_all(hlcd[i]));
+		LCD_FrameEnd(hlcd[i]);
+	}
+}
+
+/** @brief Проверка, что в теневом буфере есть неотправленные ячейки
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- есть изменения, 0 -- дисплей обновлён
+ */
+uint8_t LCD_IsDirty (LCD_HandleTypeDef *hlcd)
+{
+	uint8_t row = 0, col = 0;
+	return s_next_dirty(hlcd, &row, &col, hlcd->Geometry->Rows);
+}
+
+/** @brief Отправляет не больше cells изменённых ячеек одним кадром
+ *  @note
+ *  	Для планировщика шины (lcd_bus.h): обновление дисплея
+ *  	делится на кадры ограниченного размера, чтобы кадры
+ *  	разных дисплеев на одной шине чередовались
+ *  @param [in] hlcd  дескриптор дисплея
+ *  @param [in] cells наибольшее число ячеек в кадре
+ *  @return 1 -- изменённые ячейки ещё остались, 0 -- дисплей обновлён
+ */
+uint8_t LCD_FlushPart (LCD_HandleTypeDef *hlcd, uint16_t cells)
+{
+	flush_channel_t ch[2];
+	s_clear_if_cheaper(hlcd);
+	LCD_FrameBegin(hlcd);
+	s_flush_round_robin(ch, s_flush_channels(hlcd, ch), cells);
+	LCD_SelectController(hlcd, s_all(hlcd));
+	LCD_FrameEnd(hlcd);
+	return LCD_IsDirty(hlcd);
+}
+
+/** @brief Бит N команды Function Set по геометрии дисплея
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 0b00001000 -- две строки контроллера, 0 -- одна
+ */
+static inline uint8_t s_lines (LCD_HandleTypeDef *hlcd)
+{
+	return (hlcd->Geometry->Lines == 2) ? 0b00001000 : 0;
+}
+
+/** @brief Общая часть инициализации после Function Set
+ *  @note
+ *  	Отправляется безусловно: теневые регистры после LCD_TransportInit
+ *  	неизвестны. Дисплей включается один раз, очистка ставит AC в 0,
+ *  	поэтому Display Off и Return Home не нужны
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_lcd_init_common (LCD_HandleTypeDef *hlcd)
+{
+	LCD_SendCommand(hlcd, LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON); // дисплей включён, курсор выключен
+	LCD_SendCommand(hlcd, 0b00000001);   // очистка дисплея
+	LCD_SendCommand(hlcd, LCD_ENTRY_MODE | LCD_ENTRY_INC);        // режим ввода: AC++, без сдвига
+	LCD_WaitMs(10);
+}
+
+/** @brief Инициализация дисплея в 8битном режиме
+ *  @param [in] hlcd дескриптор дисплея
+ */
+static void s_lcd_init_8bit (LCD_HandleTypeDef *hlcd)
+{
+	LCD_WaitMs(15); 				   // Задержка после подачи питания
+	LCD_SendCommand(hlcd, 0b00110000);   // 8ми битный интерфейс
+	LCD_WaitMs(5);
+	LCD_SendCommand(hlcd, 0b00110000);   // 8ми битный интерфейс
+	LCD_WaitMs(1);
+	LCD_SendCommand(hlcd, 0b00110000 | s_lines(hlcd)); // 8ми битный интерфейс, число строк контроллера
+	LCD_WaitMs(1);
+	s_lcd_init_common(hlcd);
+}
 
 /** @brief инициализировать LCD в 4 битном режиме
  *  @details
@@ -74,41 +440,181 @@ static void s_lcd_init_8bit (void)
  *  	Получит сначала 0b0000000, а потом 0b00100000
  *  	Теперь, 4 битный режим включён и можно передавать байты, как есть
  *  	без учёта того, что команда передаётся полубайтами
+ *  @param [in] hlcd дескриптор дисплея
  *  @return None
  */
-static void s_lcd_init_4bit (void)
+static void s_lcd_init_4bit (LCD_HandleTypeDef *hlcd)
 {
-	HAL_Delay(25);                 // Задержка после подачи питания
-	LCD_SendCommand(0b00110011);   // 8 битный интерфейс. Повторяется два раза
-	HAL_Delay(5);
+	LCD_WaitMs(25);                 // Задержка после подачи питания
+	LCD_SendCommand(hlcd, 0b00110011);   // 8 битный интерфейс. Повторяется два раза
+	LCD_WaitMs(5);
 	// Включить 4 битный режим (поскольку передаётся на 4 старших
 	// бита, первые 0000, далее, забрасываем режим 4 бита
-	LCD_SendCommand(0b00000010);
-	HAL_Delay(5);
+	LCD_SendCommand(hlcd, 0b00000010);
+	LCD_WaitMs(5);
 	// Теперь, можно передавать полубайтами, байт, как есть.
-	LCD_SendCommand(0b00101000);   // Включить 2 строки, 4 бита
-	LCD_SendCommand(0b00001000);   // Выключить дисплей
-	LCD_SendCommand(0b00000010);   // установка курсора в начале строки
-	LCD_SendCommand(0b00001100);   // нормальный режим работы, выкл курсор
-	LCD_SendCommand(0b00000001);   // очистка дисплея
-	LCD_SendCommand(0b00000010);   // режим ввода
-	HAL_Delay(10);
+	LCD_SendCommand(hlcd, 0b00100000 | s_lines(hlcd)); // 4 бита, число строк контроллера
+	s_lcd_init_common(hlcd);
 }
-#endif
 
-void LCD_Init(void)
+/** @brief Инициализация дисплея
+ *  @note
+ *  	Поля настроек дескриптора (Transport, Bus, Address, EPort/EPin,
+ *  	Geometry) заполняются до вызова. Геометрия больше теневого
+ *  	буфера (LCD_ROWS x LCD_COLS) -- Error_Handler. Последовательность
+ *  	инициализации выбирается по ширине шины транспорта.
+ *  	У дисплея 40x4 команды инициализации и очистки уходят
+ *  	обоим контроллерам сразу (LCD_ENABLE_BOTH)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+void LCD_Init(LCD_HandleTypeDef *hlcd)
 {
-	LCD_TransportInit();
-#if LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE
-	s_lcd_init_4bit ();
-#elif LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE
-	s_lcd_init_8bit ();
-#endif
+	if (hlcd->Geometry == NULL)
+		hlcd->Geometry = &LCD_Geometry16x2;
+	if (hlcd->Geometry->Rows > LCD_ROWS || hlcd->Geometry->Cols > LCD_COLS)
+	{
+		Error_Handler();
+	}
+	LCD_TransportInit(hlcd);
+	LCD_SelectController(hlcd, s_all(hlcd));
+	if (hlcd->Transport->Width == LCD_DATA_WIDTH_HALF_BYTE)
+		s_lcd_init_4bit (hlcd);
+	else
+		s_lcd_init_8bit (hlcd);
+	s_frame_reset (hlcd);
 }
 
-void LCD_Clear (void)
+/** @brief Очищает дисплей и теневой буфер
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+void LCD_Clear (LCD_HandleTypeDef *hlcd)
 {
-	LCD_SendCommand(0b00000001);
+	LCD_SendCommand(hlcd, 0b00000001);
+	s_frame_reset (hlcd);
 }
 
+/** @brief Очищает только теневой буфер
+ *  @note
+ *  	В дисплей ничего не отправляется. Непустые ячейки, уже
+ *  	отправленные в дисплей, помечаются стёртыми (Blank): символ
+ *  	на экране остаётся в Frame, и если новый экран запишет в ячейку
+ *  	тот же символ, она не отправляется вовсе. Остальные стёртые
+ *  	ячейки станут пробелами при LCD_Flush, который сам выберет,
+ *  	что быстрее -- перезаписать их или очистить дисплей командой
+ *  	0x01 (s_clear_if_cheaper)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+void LCD_SoftClear (LCD_HandleTypeDef *hlcd)
+{
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
+	for (uint8_t row = 0; row < geo->Rows; row ++)
+	{
+		for (uint8_t col = 0; col < geo->Cols; col ++)
+		{
+			uint8_t bit = (uint8_t) (1 << (col & 0x07));
+			if (hlcd->Frame[row][col] == ' ' || (hlcd->Blank[row][col >> 3] & bit))
+				continue;
+			if (hlcd->Dirty[row][col >> 3] & bit)
+				hlcd->Frame[row][col] = ' '; // Символ ещё не отправлен, на экране неизвестно что
+			else
+				hlcd->Blank[row][col >> 3] |= bit;
+			hlcd->Dirty[row][col >> 3] |= bit;
+		}
+	}
+	hlcd->Row = 0;
+	hlcd->Col = 0;
+}
 
+/** @brief Отправляет команду, только если она меняет теневой регистр
+ *  @note
+ *  	Теневой регистр обновляет сам транспорт (s_track_command).
+ *  	Неизвестный регистр (0) не совпадает ни с одной командой
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] shadow текущее значение теневого регистра
+ *  @param [in] cmd команда
+ *  @return None
+ */
+static void s_write_register (LCD_HandleTypeDef *hlcd, uint8_t shadow, uint8_t cmd)
+{
+	if (shadow != cmd)
+		LCD_SendCommand(hlcd, cmd);
+}
+
+/** @brief Устанавливает или сбрасывает бит регистра
+ *  @param [in] reg значение регистра
+ *  @param [in] mask бит
+ *  @param [in] on 1 -- установить, 0 -- сбросить
+ *  @return новое значение регистра
+ */
+static inline uint8_t s_bit (uint8_t reg, uint8_t mask, uint8_t on)
+{
+	return on ? (reg | mask) : (uint8_t)(reg & ~mask);
+}
+
+/** @brief Включает/выключает изображение (содержимое DDRAM сохраняется)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] on 1 -- включить, 0 -- выключить
+ *  @return None
+ */
+void LCD_DisplayOn (LCD_HandleTypeDef *hlcd, uint8_t on)
+{
+	s_write_register(hlcd, hlcd->DisplayControl,
+		s_bit(hlcd->DisplayControl | LCD_DISPLAY_CONTROL, LCD_DISPLAY_ON, on));
+}
+
+/** @brief Показывает/скрывает курсор-подчёркивание
+ *  @note
+ *  	Курсор стоит там, куда указывает AC, т.е. после последней
+ *  	записанной LCD_Flush ячейки, а не в позиции LCD_SetCursor
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] on 1 -- показать, 0 -- скрыть
+ *  @return None
+ */
+void LCD_CursorOn (LCD_HandleTypeDef *hlcd, uint8_t on)
+{
+	s_write_register(hlcd, hlcd->DisplayControl,
+		s_bit(hlcd->DisplayControl | LCD_DISPLAY_CONTROL, LCD_CURSOR_ON, on));
+}
+
+/** @brief Включает/выключает мигание знакоместа под курсором
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] on 1 -- мигать, 0 -- нет
+ *  @return None
+ */
+void LCD_BlinkOn (LCD_HandleTypeDef *hlcd, uint8_t on)
+{
+	s_write_register(hlcd, hlcd->DisplayControl,
+		s_bit(hlcd->DisplayControl | LCD_DISPLAY_CONTROL, LCD_BLINK_ON, on));
+}
+
+/** @brief Направление ввода (бит I/D Entry Mode Set)
+ *  @note
+ *  	Теневой буфер по-прежнему хранит строку слева направо.
+ *  	При вводе справа налево LCD_Flush ставит адрес перед каждой
+ *  	ячейкой (счётчик адреса уходит в другую сторону)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] ltr 1 -- слева направо, 0 -- справа налево
+ *  @return None
+ */
+void LCD_LeftToRight (LCD_HandleTypeDef *hlcd, uint8_t ltr)
+{
+	s_write_register(hlcd, hlcd->EntryMode,
+		s_bit(hlcd->EntryMode | LCD_ENTRY_MODE, LCD_ENTRY_INC, ltr));
+}
+
+/** @brief Сдвиг изображения при каждой записи (бит S Entry Mode Set)
+ *  @note
+ *  	Сдвиг учитывается в адресах LCD_Flush (LCD_HandleTypeDef::Shift),
+ *  	но содержимое теневого буфера вместе с изображением не сдвигается
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] on 1 -- сдвигать, 0 -- нет
+ *  @return None
+ */
+void LCD_Autoscroll (LCD_HandleTypeDef *hlcd, uint8_t on)
+{
+	s_write_register(hlcd, hlcd->EntryMode,
+		s_bit(hlcd->EntryMode | LCD_ENTRY_MODE, LCD_ENTRY_SHIFT, on));
+}
@@ -0,0 +1,242 @@
+/*
+ * lcd_array.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd_array.h"
+
+#include <string.h>
+
+#if (LCD_DATA_TRANSPORT_GPIO != 0) ///?> Массив дисплеев -- только на общей шине GPIO
+
+#if (LCD_ARRAY_SIZE + 1 > LCD_MAX_DISPLAYS)
+#error "LCD_ARRAY_SIZE + 1 не больше LCD_MAX_DISPLAYS (широковещательный дескриптор тоже в реестре)"
+#endif
+
+/** @brief Подготовка к широковещательным инструкциям
+ *  @note
+ *  	Строб общий, поэтому инструкция не должна застать ни один
+ *  	дисплей занятым. Широковещательный дескриптор берёт теневые
+ *  	регистры и сдвиг изображения дисплеев, только если они у всех одинаковы, иначе
+ *  	инструкции отправляются каждому дисплею отдельно. Счётчик
+ *  	адреса известен, только если у всех дисплеев он одинаков
+ *  @param [in] harr дескриптор массива
+ *  @return 1 -- можно отправлять широковещательно, 0 -- регистры дисплеев различаются
+ */
+static uint8_t s_wait_displays (LCD_ArrayTypeDef *harr)
+{
+	LCD_HandleTypeDef *first = harr->Displays[0];
+	for (uint8_t i = 1; i < harr->Count; i ++)
+	{
+		LCD_HandleTypeDef *hlcd = harr->Displays[i];
+		if (hlcd->EntryMode != first->EntryMode || hlcd->DisplayControl != first->DisplayControl ||
+			hlcd->FunctionSet != first->FunctionSet || hlcd->Shift != first->Shift)
+			return 0;
+	}
+	harr->All.Counter[0]     = first->Counter[0];
+	harr->All.EntryMode      = first->EntryMode;
+	harr->All.DisplayControl = first->DisplayControl;
+	harr->All.FunctionSet    = first->FunctionSet;
+	harr->All.Shift          = first->Shift;
+	harr->All.Cgram          = first->Cgram;
+	for (uint8_t i = 0; i < harr->Count; i ++)
+	{
+		LCD_WaitReady(harr->Displays[i], LCD_ENABLE_BOTH);
+		if (harr->Displays[i]->Counter[0] != harr->All.Counter[0])
+			harr->All.Counter[0] = LCD_NO_ADDRESS;
+	}
+	return 1;
+}
+
+/** @brief Переносит состояние контроллеров после широковещательных инструкций на дисплеи
+ *  @note
+ *  	Счётчик адреса, теневые регистры и сдвиг изображения у всех
+ *  	дисплеев теперь одинаковы.
+ *  	Момент отправки и время выполнения последней инструкции
+ *  	переходят в дисплеи, каждый дождётся её сам перед следующим
+ *  	обращением к нему (сколько бы он ни простаивал). Ожидание
+ *  	снимается с широковещательного дескриптора
+ *  @param [in] harr дескриптор массива
+ *  @return None
+ */
+static void s_sync_pending (LCD_ArrayTypeDef *harr)
+{
+	for (uint8_t i = 0; i < harr->Count; i ++)
+	{
+		LCD_HandleTypeDef *hlcd = harr->Displays[i];
+		hlcd->Counter[0] = harr->All.Counter[0];
+		hlcd->EntryMode  = harr->All.EntryMode;
+		hlcd->DisplayControl = harr->All.DisplayControl;
+		hlcd->FunctionSet    = harr->All.FunctionSet;
+		hlcd->Shift          = harr->All.Shift;
+		hlcd->Cgram          = harr->All.Cgram;
+		if (harr->All.Pending & LCD_ENABLE_E1)
+		{
+			hlcd->Pending |= LCD_ENABLE_E1;
+			hlcd->Issued[0] = harr->All.Issued[0];
+			hlcd->Busy[0]   = harr->All.Busy[0];
+		}
+	}
+	harr->All.Pending = 0;
+}
+
+/** @brief Копирует теневой буфер широковещательного дескриптора в дисплеи
+ *  @note
+ *  	Вызывается после инициализации и очистки, когда содержимое
+ *  	всех дисплеев одинаково
+ *  @param [in] harr дескриптор массива
+ *  @return None
+ */
+static void s_copy_frame (LCD_ArrayTypeDef *harr)
+{
+	for (uint8_t i = 0; i < harr->Count; i ++)
+	{
+		LCD_HandleTypeDef *hlcd = harr->Displays[i];
+		memcpy(hlcd->Frame, harr->All.Frame, sizeof(hlcd->Frame));
+		memcpy(hlcd->Dirty, harr->All.Dirty, sizeof(hlcd->Dirty));
+		memcpy(hlcd->Blank, harr->All.Blank, sizeof(hlcd->Blank));
+		hlcd->Row = harr->All.Row;
+		hlcd->Col = harr->All.Col;
+	}
+}
+
+/** @brief Инициализация массива дисплеев
+ *  @note
+ *  	Дисплеи массива заполняются до вызова: Transport -- LCD_TransportGpio,
+ *  	EPort/EPin -- свой строб E, Geometry -- одна на всех (не 40x4).
+ *  	Стробы всех дисплеев -- на одном порту, широковещательный
+ *  	дескриптор стробирует их одной записью в BSRR. Иначе -- Error_Handler.
+ *  	Последовательность инициализации отправляется всем дисплеям сразу
+ *  @param [in] harr дескриптор массива
+ *  @return None
+ */
+void LCD_ArrayInit (LCD_ArrayTypeDef *harr)
+{
+	LCD_HandleTypeDef *all = &harr->All;
+	if (harr->Count == 0 || harr->Count > LCD_ARRAY_SIZE)
+	{
+		Error_Handler();
+	}
+	all->EPin = 0;
+	for (uint8_t i = 0; i < harr->Count; i ++)
+	{
+		LCD_HandleTypeDef *hlcd = harr->Displays[i];
+		if (hlcd->Geometry == NULL)
+			hlcd->Geometry = &LCD_Geometry16x2;
+		if (hlcd->Transport != &LCD_TransportGpio)
+		{
+			Error_Handler(); // Общая шина данных -- только у транспорта GPIO
+		}
+		LCD_TransportInit(hlcd); // Реестр и строб E по умолчанию
+		if (hlcd->EPort != harr->Displays[0]->EPort || hlcd->Geometry != harr->Displays[0]->Geometry ||
+			hlcd->Geometry->E2Row || (all->EPin & hlcd->EPin))
+		{
+			Error_Handler(); // Стробы на разных портах или совпадают, разные модули
+		}
+		all->EPin |= hlcd->EPin;
+	}
+	all->Transport = &LCD_TransportGpio;
+	all->Bus       = NULL;
+	all->Address   = 0;
+	all->EPort     = harr->Displays[0]->EPort;
+	all->E2Port    = NULL;
+	all->E2Pin     = 0;
+	all->Geometry  = harr->Displays[0]->Geometry;
+	LCD_Init(all);
+	s_copy_frame(harr);
+	s_sync_pending(harr);
+}
+
+/** @brief Позиционирует курсор теневого буфера всех дисплеев
+ *  @param [in] harr дескриптор массива
+ *  @param [in] row № строки (начинается с 0)
+ *  @param [in] col № колонки (начинается с 0)
+ *  @return None
+ */
+void LCD_ArraySetCursor (LCD_ArrayTypeDef *harr, uint8_t row, uint8_t col)
+{
+	for (uint8_t i = 0; i < harr->Count; i ++)
+		LCD_SetCursor(harr->Displays[i], row, col);
+}
+
+/** @brief Записывает строку в теневой буфер всех дисплеев
+ *  @param [in] harr дескриптор массива
+ *  @param [in] str указатель на строку
+ *  @param [in] size размер строки в байтах
+ *  @return None
+ */
+void LCD_ArraySendString (LCD_ArrayTypeDef *harr, char *str, uint8_t size)
+{
+	for (uint8_t i = 0; i < harr->Count; i ++)
+		LCD_SendString(harr->Displays[i], str, size);
+}
+
+/** @brief Проверяет, совпадают ли теневые буферы и карты изменений всех дисплеев
+ *  @param [in] harr дескриптор массива
+ *  @return 1 -- совпадают, 0 -- нет
+ */
+static uint8_t s_same_frames (LCD_ArrayTypeDef *harr)
+{
+	LCD_HandleTypeDef *first = harr->Displays[0];
+	for (uint8_t i = 1; i < harr->Count; i ++)
+	{
+		LCD_HandleTypeDef *hlcd = harr->Displays[i];
+		if (memcmp(hlcd->Dirty, first->Dirty, sizeof(hlcd->Dirty)) != 0 ||
+			memcmp(hlcd->Blank, first->Blank, sizeof(hlcd->Blank)) != 0 ||
+			memcmp(hlcd->Frame, first->Frame, sizeof(hlcd->Frame)) != 0)
+			return 0;
+	}
+	return 1;
+}
+
+/** @brief Отправляет изменения всех дисплеев массива
+ *  @note
+ *  	Если теневые буферы, карты изменений и теневые регистры всех
+ *  	дисплеев совпадают, изменения отправляются один раз
+ *  	широковещательным стробом. Иначе дисплеи пишутся вперемежку
+ *  	(LCD_FlushAll): время выполнения каждого прячется за записью остальных
+ *  @param [in] harr дескриптор массива
+ *  @return None
+ */
+void LCD_ArrayFlush (LCD_ArrayTypeDef *harr)
+{
+	if (!s_same_frames(harr) || !s_wait_displays(harr))
+	{
+		LCD_FlushAll(harr->Displays, harr->Count);
+		return;
+	}
+	memcpy(harr->All.Frame, harr->Displays[0]->Frame, sizeof(harr->All.Frame));
+	memcpy(harr->All.Dirty, harr->Displays[0]->Dirty, sizeof(harr->All.Dirty));
+	memcpy(harr->All.Blank, harr->Displays[0]->Blank, sizeof(harr->All.Blank));
+	LCD_Flush(&harr->All);
+	for (uint8_t i = 0; i < harr->Count; i ++)
+	{
+		LCD_HandleTypeDef *hlcd = harr->Displays[i];
+		memcpy(hlcd->Frame, harr->All.Frame, sizeof(hlcd->Frame)); // Стёртые ячейки стали пробелами
+		memset(hlcd->Dirty, 0, sizeof(hlcd->Dirty));
+		memset(hlcd->Blank, 0, sizeof(hlcd->Blank));
+	}
+	s_sync_pending(harr);
+}
+
+/** @brief Очищает все дисплеи массива одной командой
+ *  @note
+ *  	Если теневые регистры дисплеев различаются (дисплеи настраивались
+ *  	по отдельности), каждый дисплей очищается своей командой
+ *  @param [in] harr дескриптор массива
+ *  @return None
+ */
+void LCD_ArrayClear (LCD_ArrayTypeDef *harr)
+{
+	if (!s_wait_displays(harr))
+	{
+		for (uint8_t i = 0; i < harr->Count; i ++)
+			LCD_Clear(harr->Displays[i]);
+		return;
+	}
+	LCD_Clear(&harr->All);
+	s_copy_frame(harr);
+	s_sync_pending(harr);
+}
+#endif
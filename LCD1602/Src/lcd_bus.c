@@ -0,0 +1,143 @@
+/*
+ * lcd_bus.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd_bus.h"
+
+#if (LCD_DATA_TRANSPORT_PCF8574T != 0) ///?> Планировщик -- для дисплеев PCF8574T на общей шине I2C
+
+#if (LCD_BUS_SIZE > 16)
+#error "LCD_BUS_SIZE не больше 16 (адреса 0x20-0x27 и 0x38-0x3F)"
+#endif
+
+#if (LCD_BUS_SIZE > LCD_MAX_DISPLAYS)
+#error "LCD_BUS_SIZE не больше LCD_MAX_DISPLAYS (каждый дисплей шины -- в реестре драйвера)"
+#endif
+
+/** @brief Инициализация дисплеев шины
+ *  @note
+ *  	Дисплеи заполняются до вызова: Transport -- LCD_TransportPCF8574T,
+ *  	Bus -- общая шина, Address -- свой адрес (PCF8574 0x20-0x27,
+ *  	PCF8574A 0x38-0x3F, до 16 модулей). Разные шины или
+ *  	совпадающие адреса -- Error_Handler. Каждому дисплею нужен
+ *  	контекст транспорта, поэтому LCD_BUS_SIZE -- это
+ *  	LCD_PCF8574T_INSTANCES, и дисплеев на всех шинах не больше
+ *  	его (иначе Error_Handler в LCD_Init). Для 16 модулей на шине --
+ *  	LCD_PCF8574T_INSTANCES и LCD_MAX_DISPLAYS 16 (ОЗУ -- в
+ *  	lcd_data_transport.h)
+ *  @param [in] hbus дескриптор планировщика
+ *  @return None
+ */
+void LCD_BusInit (LCD_BusTypeDef *hbus)
+{
+	if (hbus->Count == 0 || hbus->Count > LCD_BUS_SIZE)
+	{
+		Error_Handler();
+	}
+	for (uint8_t i = 0; i < hbus->Count; i ++)
+	{
+		LCD_HandleTypeDef *hlcd = hbus->Displays[i];
+		if (hlcd->Transport != &LCD_TransportPCF8574T)
+		{
+			Error_Handler();
+		}
+		LCD_Init(hlcd); // Шина и адрес по умолчанию
+		for (uint8_t j = 0; j < i; j ++)
+		{
+			if (hbus->Displays[j]->Bus != hlcd->Bus || hbus->Displays[j]->Address == hlcd->Address)
+			{
+				Error_Handler(); // Дисплеи на разных шинах или с одним адресом
+			}
+		}
+		hbus->Refreshes[i] = 0;
+		hbus->Rate[i]      = 0;
+	}
+	hbus->Next   = 0;
+	hbus->Window = HAL_GetTick();
+}
+
+/** @brief Шаг планировщика, вызывается из основного цикла
+ *  @note
+ *  	За один обход каждый дисплей с изменениями получает не больше
+ *  	одного кадра (LCD_BUS_BATCH_CELLS ячеек), обход каждый раз
+ *  	начинается со следующего дисплея. Кадры ставятся в общую
+ *  	очередь шины и передаются через DMA друг за другом,
+ *  	пока основной цикл готовит следующие. Дисплей, у которого
+ *  	оба буфера кадра ещё ждут передачи, пропускается до
+ *  	следующего обхода, поэтому шаг не блокируется.
+ *  	Без DMA кадры передаются сразу (блокирующие транзакции)
+ *  @param [in] hbus дескриптор планировщика
+ *  @return None
+ */
+void LCD_BusProcess (LCD_BusTypeDef *hbus)
+{
+	uint8_t i = hbus->Next;
+	for (uint8_t n = 0; n < hbus->Count; n ++)
+	{
+		LCD_HandleTypeDef *hlcd = hbus->Displays[i];
+		if (!LCD_FrameBusy(hlcd) && LCD_IsDirty(hlcd) && !LCD_FlushPart(hlcd, LCD_BUS_BATCH_CELLS))
+			hbus->Refreshes[i] ++; // Все изменения дисплея отправлены
+		if (++ i >= hbus->Count)
+			i = 0;
+	}
+	if (++ hbus->Next >= hbus->Count)
+		hbus->Next = 0;
+
+	uint32_t elapsed = HAL_GetTick() - hbus->Window;
+	if (elapsed >= LCD_BUS_RATE_MS)
+	{
+		for (uint8_t k = 0; k < hbus->Count; k ++)
+		{
+			hbus->Rate[k] = (uint16_t) (hbus->Refreshes[k] * 1000U / elapsed);
+			hbus->Refreshes[k] = 0;
+		}
+		hbus->Window += elapsed;
+	}
+}
+
+/** @brief Обновляет все дисплеи нескольких шин и ждёт окончания передачи
+ *  @note
+ *  	Шаги планировщиков шин чередуются, поэтому кадры всех шин
+ *  	стоят в очередях одновременно и передаются через DMA
+ *  	параллельно: время обновления -- время самой загруженной шины,
+ *  	а не сумма. Без DMA шины обновляются блокирующими
+ *  	транзакциями по очереди
+ *  @param [in] hbus  массив планировщиков (по одному на шину I2C1-I2C3)
+ *  @param [in] count число планировщиков
+ *  @return None
+ */
+void LCD_BusFlushAll (LCD_BusTypeDef *const *hbus, uint8_t count)
+{
+	uint8_t dirty;
+	do
+	{
+		dirty = 0;
+		for (uint8_t b = 0; b < count; b ++)
+		{
+			LCD_BusProcess(hbus[b]);
+			for (uint8_t i = 0; i < hbus[b]->Count; i ++)
+				dirty |= LCD_IsDirty(hbus[b]->Displays[i]);
+		}
+	} while (dirty);
+	for (uint8_t b = 0; b < count; b ++)
+	{
+		while (LCD_I2cBusy((I2C_HandleTypeDef *) hbus[b]->Displays[0]->Bus))
+			;
+	}
+}
+
+/** @brief Частота обновления дисплея
+ *  @note
+ *  	Число законченных обновлений (отправлены все изменения
+ *  	теневого буфера) в секунду за последнее окно LCD_BUS_RATE_MS
+ *  @param [in] hbus  дескриптор планировщика
+ *  @param [in] index № дисплея в LCD_BusTypeDef::Displays
+ *  @return обновлений в секунду
+ */
+uint16_t LCD_BusRate (LCD_BusTypeDef *hbus, uint8_t index)
+{
+	return (index < hbus->Count) ? hbus->Rate[index] : 0;
+}
+#endif
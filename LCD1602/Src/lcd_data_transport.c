@@ -4,494 +4,592 @@
  *  Created on: Dec 2, 2024
  *      Author: denis
  */
-#include "lcd_data_transport.h"
-#include "gpio.h"
+#include "lcd1602.h"
+#include "lcd_delay.h"
 
-#define STUPID_DELAY 400
+#include <string.h>
 
-/// Объявления локальных статических функций
-static void s_send_data       (uint8_t data);   ///?> Отправка байта данных LCD1602  (+RS Строб)
-static void s_send_command    (uint8_t data);   ///?> Отправка байта команды LCD1602
-static void s_stupid_delay    (uint32_t delay); ///?> Ожидание в цикле
-static void s_transport_init  (void);           ///?> Инициализация транспорта, если нужно
+/// Транспорты сами в lcd_transport_*.c, здесь -- общая часть: реестр
+/// дисплеев, ожидание выполнения инструкций, асинхронная очередь
+/// и кадры по умолчанию. Вызов API -- один косвенный вызов через
+/// таблицу операций транспорта дисплея
 
-/** @brief "Тупое" ожидание в цикле
+#if (LCD_DATA_TRANSPORT_GPIO == 0) && (LCD_DATA_TRANSPORT_74HC595 == 0) && \
+    (LCD_DATA_TRANSPORT_PCF8574T == 0) && (LCD_DATA_TRANSPORT_FSMC == 0)
+#error "Не выбран ни один транспорт (LCD_DATA_TRANSPORT_*)"
+#endif
+
+#if (LCD_MAX_DISPLAYS > 16)
+#error "LCD_MAX_DISPLAYS не больше 16 (номер дисплея -- 4 бита операции очереди)"
+#endif
+
+/// Вывод кадров через DMA (таймер, поток DMA) у каждого транспорта свой
+#define USE_GPIO_DMA ((LCD_DATA_TRANSPORT_GPIO != 0) && (LCD_GPIO_DMA != 0))
+#define USE_SPI_DMA  ((LCD_DATA_TRANSPORT_74HC595 != 0) && (LCD_74HC595_SPI != 0) && (LCD_74HC595_DMA != 0))
+#define USE_FSMC_DMA ((LCD_DATA_TRANSPORT_FSMC != 0) && (LCD_FSMC_DMA != 0))
+#define USE_I2C_DMA  ((LCD_DATA_TRANSPORT_PCF8574T != 0) && (LCD_PCF8574T_DMA != 0))
+
+#if ((USE_GPIO_DMA != 0) || (USE_SPI_DMA != 0) || (USE_FSMC_DMA != 0) || (USE_I2C_DMA != 0)) && \
+    (LCD_ASYNC_MODE != 0)
+#error "Асинхронный режим и вывод кадров через DMA взаимоисключающие"
+#endif
+
+#if (LCD_DATA_TRANSPORT_74HC595 != 0) && (LCD_74HC595_DMA != 0) && (LCD_74HC595_SPI == 0)
+#error "Вывод кадров 74HC595 через DMA возможен только с SPI (LCD_74HC595_SPI)"
+#endif
+
+#if (USE_GPIO_DMA != 0) && (USE_FSMC_DMA != 0)
+#error "Кадры GPIO и FSMC через DMA заняли бы один поток DMA2 Stream5 и TIM1"
+#endif
+
+#if (USE_SPI_DMA != 0) && (USE_I2C_DMA != 0)
+#error "Кадры 74HC595 и PCF8574T через DMA заняли бы один поток DMA1 Stream6"
+#endif
+
+static LCD_HandleTypeDef *s_handles[LCD_MAX_DISPLAYS]; ///?> Реестр дисплеев, индекс -- LCD_HandleTypeDef::Id
+static uint8_t            s_handles_count = 0;         ///?> Число зарегистрированных дисплеев
+
+/** @brief Ожидание, пока контроллеры enable выполнят последнюю инструкцию
  *  @note
- *  	Использовать в этом случае синхронизацию по таймеру не вижу смысла
- *  	Хотя, самым перфектным решением было бы пустить данные через DMA на порт
+ *  	Ожидание отложенное: инструкция отправляется без паузы, а срок
+ *  	её выполнения проверяется перед следующим обращением к тому же
+ *  	контроллеру. Поэтому второй контроллер модуля 40x4 можно писать,
+ *  	пока первый выполняет инструкцию.
+ *  	Если транспорт умеет опрашивать флаг занятости (GPIO с линией RW),
+ *  	ожидает он сам, иначе -- пока с момента отправки не пройдёт
+ *  	время по таблице выбранного контроллера (lcd_timing.h)
+ *  @param [in] hlcd   дескриптор дисплея
+ *  @param [in] enable контроллеры (LCD_ENABLE_*)
  *  @return None
  */
-static inline void s_stupid_delay   (uint32_t delay)
+void LCD_WaitReady (LCD_HandleTypeDef *hlcd, uint8_t enable)
 {
-	while(delay)
-		delay --;
+	uint8_t wait = hlcd->Pending & enable;
+	if (wait == 0)
+		return;
+	if (hlcd->Transport->WaitReady)
+		hlcd->Transport->WaitReady(hlcd, wait);
+	else
+	{
+		if (wait & LCD_ENABLE_E1)
+			LCD_DelaySince(hlcd->Issued[0], hlcd->Busy[0]);
+		if (wait & LCD_ENABLE_E2)
+			LCD_DelaySince(hlcd->Issued[1], hlcd->Busy[1]);
+	}
+	hlcd->Pending &= (uint8_t) ~wait;
 }
 
-
-/** @brief Предварительная инициализация
- *	@note
- *		В любой реализации транспорта должна присуствовать хотя бы заглушка этой функции
- *	@return None
+#if (LCD_ASYNC_MODE == 0)
+/** @brief Запоминает момент отправки и время выполнения инструкции
+ *  @param [in] hlcd  дескриптор дисплея
+ *  @param [in] instr класс отправленной инструкции
+ *  @return None
  */
-void LCD_TransportInit (void)
+static inline void s_mark_busy (LCD_HandleTypeDef *hlcd, LCD_InstrClass instr)
 {
-	s_transport_init ();
+	uint32_t issued = LCD_DelayStamp();
+	uint16_t busy   = (uint16_t) LCD_InstrTimeUs(instr);
+	if (hlcd->Enable & LCD_ENABLE_E1)
+	{
+		hlcd->Issued[0] = issued;
+		hlcd->Busy[0]   = busy;
+	}
+	if (hlcd->Enable & LCD_ENABLE_E2)
+	{
+		hlcd->Issued[1] = issued;
+		hlcd->Busy[1]   = busy;
+	}
+	hlcd->Pending |= hlcd->Enable;
 }
+#endif
 
-/** @brief Отправляет байт, как команду (Линия RS не стробируется)
+#if (LCD_ASYNC_MODE != 0)
+
+#if (LCD_ASYNC_QUEUE_SIZE & (LCD_ASYNC_QUEUE_SIZE - 1)) != 0
+#error "LCD_ASYNC_QUEUE_SIZE должен быть степенью двойки"
+#endif
+
+/// Кодирование операций очереди: младший байт -- значение, биты 8-9 -- вид операции,
+/// биты 10-11 -- контроллеры (LCD_ENABLE_*), биты 12-15 -- номер дисплея в реестре
+#define OP_COMMAND   0x0000 ///?> Команда (RS = 0)
+#define OP_DATA      0x0100 ///?> Данные (RS = 1)
+#define OP_DELAY     0x0200 ///?> Пауза, значение в мс
+#define OP_TYPE_MSK  0x0300 ///?> Маска вида операции
+#define OP_ENABLE_Pos 10    ///?> Позиция маски контроллеров
+#define OP_ID_Pos    12     ///?> Позиция номера дисплея
+#define OP_TARGET(hlcd) ((uint16_t) (((hlcd)->Id << OP_ID_Pos) | ((hlcd)->Enable << OP_ENABLE_Pos))) ///?> Дисплей и контроллеры операции
+#define OP_DELAY_MAX 60     ///?> Максимальная пауза одной операции, мс (16-битный TIM7 на 1 МГц)
+
+static uint16_t          s_queue[LCD_ASYNC_QUEUE_SIZE]; ///?> Кольцевой буфер операций
+static volatile uint16_t s_queue_head = 0;  ///?> Индекс записи, меняет только основной цикл
+static volatile uint16_t s_queue_tail = 0;  ///?> Индекс чтения, меняет только прерывание TIM7
+static volatile uint8_t  s_async_idle = 1;  ///?> Таймер остановлен, очередь выбрана
+
+/** @brief Настройка TIM7 как одноимпульсного таймера с тактом 1 МГц
  *  @note
- *  	Пины:
- *  	RS_Pin -- не стробируется
- *  	E_Pin  -- стробируется
- *  	s_send_command должна быть определена в соответствующем транспорте
+ *  	Период каждого запуска равен времени выполнения отправленной
+ *  	инструкции, по прерыванию переполнения отправляется следующая
  *  @return None
  */
-void LCD_SendCommand(uint8_t data)
+static void s_async_init (void)
 {
-	s_send_command (data);
-	HAL_Delay(1);
+	uint32_t clock = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+		clock *= 2; // Таймеры APB1 тактируются удвоенной частотой шины
+
+	__HAL_RCC_TIM7_CLK_ENABLE();
+	TIM7->CR1  = TIM_CR1_OPM | TIM_CR1_URS; // Один период, прерывание только по переполнению
+	TIM7->PSC  = clock / 1000000U - 1;
+	TIM7->EGR  = TIM_EGR_UG;                 // Загрузить предделитель
+	TIM7->SR   = 0;
+	TIM7->DIER = TIM_DIER_UIE;
+	HAL_NVIC_SetPriority(TIM7_IRQn, LCD_ASYNC_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(TIM7_IRQn);
 }
 
-/** @brief Отправляет байт, как данные (Линия RS стробируется)
- *  @note
- *  	Пины:
- *  	RS_Pin -- стробируется
- *  	E_Pin  -- стробируется
- *  	s_send_data должна быть определена в соответствующем транспорте
+/** @brief Запуск TIM7 на заданное время
+ *  @param [in] us время до прерывания, мкс
  *  @return None
  */
-void LCD_SendData (uint8_t data)
+static inline void s_async_start (uint32_t us)
 {
-	s_send_data (data);
-	HAL_Delay(1);
+	TIM7->ARR = (us > 1) ? (us - 1) : 1;
+	TIM7->CNT = 0;
+	TIM7->CR1 |= TIM_CR1_CEN;
 }
 
-
-#if (LCD_DATA_TRANSPORT == LCD_DATA_GPIO) ///?> Блок управления при помощи GPIO. Для полубайта и байта
-#define GPIO_PORT GPIOD
-
-static void s_set_gpio       (uint8_t data, uint32_t add);
-static void s_transport_byte (uint8_t data, uint32_t add);
-static void s_reset_gpio     (uint32_t add);
-
-/** @brief Сбрасывает порты GPIO
+/** @brief Постановка операции в очередь
  *  @note
- *  	Сбрасывает 4 порта, если выбран режим полубайта
- *  	Сбрасывает 8 портов, если выбран режим байта
+ *  	Очередь без блокировок для одного писателя (основной цикл)
+ *  	и одного читателя (прерывание TIM7). Ожидание возможно, только
+ *  	если очередь переполнена. Если таймер стоит, он запускается;
+ *  	проверка флага простоя закрыта от прерывания.
+ *  	Очередь общая для всех дисплеев, поэтому инструкции разных
+ *  	дисплеев выполняются по очереди
+ *  @param [in] op закодированная операция
+ *  @return None
  */
-static void s_reset_gpio(uint32_t add)
+static void s_async_push (uint16_t op)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-    // Очистка всех используемых пинов (сброс)
-    GPIO_PORT->BSRR = (D4_Pin | D5_Pin | D6_Pin | D7_Pin | add) << 0x10;
-#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
-    GPIO_PORT->BSRR = (D0_Pin | D1_Pin | D2_Pin | D3_Pin | D4_Pin | D5_Pin | D6_Pin | D7_Pin | add) << 0x10;
-#endif
+	while ((uint16_t) (s_queue_head - s_queue_tail) >= LCD_ASYNC_QUEUE_SIZE)
+		; // Очередь переполнена, ждём прерывания
+	s_queue[s_queue_head & (LCD_ASYNC_QUEUE_SIZE - 1)] = op;
+	__DMB();
+	s_queue_head ++;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (s_async_idle)
+	{
+		s_async_idle = 0;
+		s_async_start(1);
+	}
+	__set_PRIMASK(primask);
 }
 
-
-/** @brief устанавливает 4/8 GPIO вывода в значения присланного байта/полубайта
+/** @brief Обработчик прерывания TIM7: выполняет следующую операцию очереди
  *  @note
- *  	В зависимости от выбранной конфигурации
- *  	LCD_DATA_WIDTH = LCD_DATA_WIDTH_BYTE / LCD_DATA_WIDTH_HALF_BYTE
- *  	Устанавливает 4 пина в значения бит младшего квартета
- *  	или 8 пинов в битовые значения всего бита
- *  	В зависимости от того, выбрана 4 или 8 бит конфигурация
- *  	Пины
- *  		D0_Pin -- 8 битная передача
- *  		D1_Pin -- 8 битная передача
- *  		D2_Pin -- 8 битная передача
- *  		D3_Pin -- 8 битная передача
- *  		D4_Pin -- 8/4 битная передача
- *  		D5_Pin -- 8/4 битная передача
- *  		D6_Pin -- 8/4 битная передача
- *  		D7_Pin -- 8/4 битная передача
- *  	Должны быть уже определены и должны принадлежать одному порту
- *  	Пины
- *  		RS_Pin -- строб данных
- *  		E_Pin  -- общий строб передачи
- *  	так же уже должны быть определены и принадлежать тому же порту
- *  	Для 8 битного режима передачи надо 10 пинов
- *  	Для 4 битного режима передачи надо 6 пинов
- *  @param [in] data передаваемый байт/полубайт
+ *  	Вызывается из TIM7_IRQHandler (stm32f4xx_it.c).
+ *  	Флаг занятости BF в асинхронном режиме не опрашивается,
+ *  	время выполнения берётся из таблицы lcd_timing.h
  *  @return None
  */
-static void s_set_gpio (uint8_t data, uint32_t add)
+void LCD_AsyncIRQHandler (void)
+{
+	uint32_t us;
+	TIM7->SR = ~TIM_SR_UIF;
+	if (s_queue_tail == s_queue_head)
+	{
+		s_async_idle = 1;
+		return;
+	}
+	uint16_t op = s_queue[s_queue_tail & (LCD_ASYNC_QUEUE_SIZE - 1)];
+	s_queue_tail ++;
+	if ((op & OP_TYPE_MSK) == OP_DELAY)
+	{
+		s_async_start ((op & 0xFF) * 1000U);
+		return;
+	}
+	// Контроллеры -- из операции, выбор основного цикла восстанавливается
+	LCD_HandleTypeDef *hlcd = s_handles[op >> OP_ID_Pos];
+	uint8_t enable = hlcd->Enable;
+	hlcd->Enable = (op >> OP_ENABLE_Pos) & LCD_ENABLE_BOTH;
+	if ((op & OP_TYPE_MSK) == OP_COMMAND)
+	{
+		hlcd->Transport->SendCommand (hlcd, (uint8_t) op);
+		us = LCD_InstrTimeUs(LCD_InstrClassify((uint8_t) op));
+	}
+	else
+	{
+		hlcd->Transport->SendData (hlcd, (uint8_t) op);
+		us = LCD_InstrTimeUs(LCD_INSTR_DATA);
+	}
+	hlcd->Enable = enable;
+	s_async_start (us);
+}
+#endif
+
+/** @brief Регистрация дисплея и инициализация его транспорта
+ *	@note
+ *		Счётчик DWT и TIM7 асинхронного режима настраиваются при
+ *		регистрации первого дисплея. Повторный вызов для того же
+ *		дескриптора номер не меняет. Если дисплеев больше
+ *		LCD_MAX_DISPLAYS, вызывается Error_Handler
+ *	@param [in] hlcd дескриптор дисплея
+ *	@return None
+ */
+void LCD_TransportInit (LCD_HandleTypeDef *hlcd)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-    // Установка необходимых бит данных
-    GPIO_PORT->BSRR = ((data & 0x01) ? D4_Pin : D4_Pin << 0x10) |
-                      ((data & 0x02) ? D5_Pin : D5_Pin << 0x10) |
-                      ((data & 0x04) ? D6_Pin : D6_Pin << 0x10) |
-                      ((data & 0x08) ? D7_Pin : D7_Pin << 0x10) |
-					  ( add );
-#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
-    // Установка необходимых бит данных
-    GPIO_PORT->BSRR =
-		((data & 0x01) ? D0_Pin : D0_Pin << 0x10) |
-		((data & 0x02) ? D1_Pin : D1_Pin << 0x10) |
-		((data & 0x04) ? D2_Pin : D2_Pin << 0x10) |
-		((data & 0x08) ? D3_Pin : D3_Pin << 0x10) |
-		((data & 0x10) ? D4_Pin : D4_Pin << 0x10) |
-		((data & 0x20) ? D5_Pin : D5_Pin << 0x10) |
-		((data & 0x40) ? D6_Pin : D6_Pin << 0x10) |
-		((data & 0x80) ? D7_Pin : D7_Pin << 0x10) |
-		 (add);
+	if (s_handles_count == 0)
+	{
+		LCD_DelayInit ();
+#if (LCD_ASYNC_MODE != 0)
+		s_async_init ();
 #endif
+	}
+	if (hlcd->Id >= s_handles_count || s_handles[hlcd->Id] != hlcd)
+	{
+		if (s_handles_count >= LCD_MAX_DISPLAYS)
+		{
+			Error_Handler();
+		}
+		hlcd->Id = s_handles_count;
+		s_handles[s_handles_count ++] = hlcd;
+	}
+	hlcd->Enable     = LCD_ENABLE_E1;
+	hlcd->Pending    = 0;
+	hlcd->Counter[0] = LCD_NO_ADDRESS;
+	hlcd->Counter[1] = LCD_NO_ADDRESS;
+	hlcd->EntryMode  = 0x06; // Состояние после сброса: I/D = 1, S = 0
+	hlcd->DisplayControl = 0;
+	hlcd->Shift          = 0;
+	hlcd->Cgram          = 0;
+	hlcd->FunctionSet    = 0;
+	hlcd->Transport->Init (hlcd);
 }
 
-/** @brief Отправляет байт через пины
+/** @brief Состояние контроллеров дисплея стало неизвестным
  *  @note
- *  	Стробирует E
- *  	Используется тупая задержка для отделения одного сигнала от другого
- *  	(Минимальное количество итераций 10 000)
- *  	Используется как для отправки полубайта, так и для отправки байта
+ *  	Вызывает транспорт, если отправленные инструкции могли дойти
+ *  	до дисплея частично (ошибка шины в фоновой передаче кадра).
+ *  	Счётчик адреса сбрасывается, весь теневой буфер помечается
+ *  	изменённым и уйдёт следующим LCD_Flush. Теневые регистры
+ *  	и сдвиг изображения транспорт отправляет заново сам
+ *  @param [in] hlcd дескриптор дисплея
  *  @return None
  */
-static void s_transport_byte (uint8_t data, uint32_t add)
+void LCD_TransportLost (LCD_HandleTypeDef *hlcd)
 {
-	s_set_gpio (data, add);         // Передача старшего полубайта
-	s_stupid_delay(STUPID_DELAY);
-	// s_reset_gpio (add);
-	GPIO_PORT->BSRR |= (add << 0x10);
-	s_stupid_delay(STUPID_DELAY);
+	hlcd->Counter[0] = LCD_NO_ADDRESS;
+	hlcd->Counter[1] = LCD_NO_ADDRESS;
+	hlcd->Cgram      = 0;
+	memset(hlcd->Dirty, 0xFF, sizeof(hlcd->Dirty));
 }
 
-/** @brief Отправляет байт, как данные (Взводится линия RS)
+/** @brief Выбор контроллеров, которым идут следующие инструкции
  *  @note
- *  	RS_Pin
- *  	E_Pin
- *  	Должны быть уже определены и принадлежать тому же порту,
- *  	что и пины данных
- *  	E_Pin стробирует передачу байта/полубайта
+ *  	У модуля 40x4 два контроллера с общей шиной и своими
+ *  	стробами E1/E2. С LCD_ENABLE_BOTH инструкция уходит обоим
+ *  	одним циклом шины. У остальных модулей -- только LCD_ENABLE_E1
+ *  @param [in] hlcd   дескриптор дисплея
+ *  @param [in] enable LCD_ENABLE_E1 / LCD_ENABLE_E2 / LCD_ENABLE_BOTH
  *  @return None
  */
-static void s_send_data (uint8_t data)
+void LCD_SelectController (LCD_HandleTypeDef *hlcd, uint8_t enable)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
-	s_transport_byte (data, E_Pin | RS_Pin);
-#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-    s_transport_byte(data >> 4, E_Pin | RS_Pin);
-    s_transport_byte(data, E_Pin | RS_Pin);
-#endif
+	hlcd->Enable = enable & LCD_ENABLE_BOTH;
 }
 
-/** @brief Отправляет байт, как команду (Линия RS не стробируется)
+/** @brief Следующее значение счётчика адреса DDRAM
  *  @note
- *  	RS_Pin -- не стробируется
- *  	E_Pin  -- стробируется
- *  	В этой реализации пины должны быть уже определены
- *  	и принадлежать тому же порту, что и пины данных
- *  @return None
+ *  	В двухстрочном режиме строки контроллера -- 0x00-0x27
+ *  	и 0x40-0x67, счётчик переходит 0x27 -> 0x40 и 0x67 -> 0x00
+ *  	(обратно при уменьшении). В однострочном -- 0x00-0x4F по кругу
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] ac   текущее значение счётчика
+ *  @param [in] inc  не 0 -- увеличение, 0 -- уменьшение
+ *  @return новое значение счётчика
  */
-static void s_send_command (uint8_t data)
+static uint8_t s_counter_step (LCD_HandleTypeDef *hlcd, uint8_t ac, uint8_t inc)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
-	s_transport_byte (data, E_Pin);
-#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-    s_transport_byte ((data >> 4) & 0x0F, E_Pin);
-    s_transport_byte (data & 0x0F, E_Pin);
-#endif
-    // Здесь нужна задержка больше 1.2 мс. Иначе инициализация проходит через раз
-    HAL_Delay(1);
+	if (ac == LCD_NO_ADDRESS)
+		return ac;
+	if (hlcd->Geometry->Lines == 2)
+	{
+		if (inc)
+			return (ac == 0x27) ? 0x40 : (ac == 0x67) ? 0x00 : (uint8_t) (ac + 1);
+		return (ac == 0x40) ? 0x27 : (ac == 0x00) ? 0x67 : (uint8_t) (ac - 1);
+	}
+	if (inc)
+		return (ac == 0x4F) ? 0x00 : (uint8_t) (ac + 1);
+	return (ac == 0x00) ? 0x4F : (uint8_t) (ac - 1);
 }
 
-/** @brief Предварительный сброс управляющих пинов RS, RW, E и пинов даннных D0-D7
- *	@return None
+/** @brief Учитывает сдвиг изображения на одну ячейку
+ *  @note
+ *  	Строка DDRAM кольцевая: 40 ячеек в двухстрочном режиме,
+ *  	80 -- в однострочном
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] left 1 -- сдвиг влево, 0 -- вправо
+ *  @return None
  */
-static void s_transport_init (void)
+static void s_shift_step (LCD_HandleTypeDef *hlcd, uint8_t left)
 {
-	s_reset_gpio(E_Pin | RS_Pin | RW_Pin);
+	uint8_t len = (hlcd->Geometry->Lines == 2) ? 40 : 80;
+	hlcd->Shift = (uint8_t) ((hlcd->Shift + (left ? 1 : len - 1)) % len);
 }
 
-#elif (LCD_DATA_TRANSPORT == LCD_DATA_74HC595)
-
-static void s_send_8bit      (uint8_t data, uint8_t add); ///?> Отправляет 8 бит вне зависимости от режима отправки со стробами E и add
-static void s_send_2x4bit    (uint8_t data, uint8_t add); ///?> Разбивает байт на два квартета и отправляет со стробами add
-static void s_set_srclk      (void); ///?> Строб 74HC595 SRCLCK (пин 10)
-static void s_transport_byte (uint8_t data);   ///?> Отправка байта с данными, зависящая от транспорта
-
-/// Биты вывода 74HC595
-#define BKL_Bit 0  ///?> Бит включения/выключения освещения подложки
-#define RS_Bit  1  ///?> Бит RS (режим данных)
-#define RW_Bit  2  ///?> Бит RW (записи в память)
-#define E_Bit   3  ///?> Бит E строба данных/команды
-#define D0_Bit  8  ///?> Бит 0 (D0, 8 битный режим)
-#define D1_Bit  9  ///?> Бит 1 (D1, 8 битный режим)
-#define D2_Bit  10 ///?> Бит 2 (D2, 8 битный режим)
-#define D3_Bit  11 ///?> Бит 3 (D3, 8 битный режим)
-#define D4_Bit  4  ///?> Бит 4 (D4, 8/4 битный режим)
-#define D5_Bit  5  ///?> Бит 5 (D5, 8/4 битный режим)
-#define D6_Bit  6  ///?> Бит 6 (D6, 8/4 битный режим)
-#define D7_Bit  7  ///?> Бит 7 (D7, 8/4 битный режим)
-
-/// Битовые маски выводов 74HC595
-#define BKL_MSK (1 << BKL_Bit) ///?> Маска бита включения/выключения освещения подложки
-#define RS_MSK  (1 << RS_Bit)  ///?> Маска бита RS (режим данных)
-#define RW_MSK  (1 << RW_Bit)  ///?> Маска бита RS (режим данных)
-#define EN_MSK  (1 << EN_Bit)  ///?> Бит E строба данных/команды
-#define D0_MSK  (1 << D0_Bit)  ///?> Маска бита 0 (D0) 8 битный режим
-#define D1_MSK  (1 << D1_Bit)  ///?> Маска бита 1 (D1) 8 битный режим
-#define D2_MSK  (1 << D2_Bit)  ///?> Маска бита 2 (D2) 8 битный режим
-#define D3_MSK  (1 << D3_Bit)  ///?> Маска бита 3 (D3) 8 битный режим
-#define D4_MSK  (1 << D4_Bit)  ///?> Маска бита 4 (D4) 8/4 битный режим
-#define D5_MSK  (1 << D3_Bit)  ///?> Маска бита 5 (D5) 8/4 битный режим
-#define D6_MSK  (1 << D2_Bit)  ///?> Маска бита 6 (D6) 8/4 битный режим
-#define D7_MSK  (1 << D1_Bit)  ///?> Маска бита 7 (D7) 8/4 битный режим
-
-/** @brief Инициализация (если нужна) транспортного протокола.
+/** @brief Учитывает команду в счётчике адреса выбранных контроллеров
  *  @note
- *  	Общая для всех видов транспорта
+ *  	Set DDRAM Address, Clear Display и Return Home задают счётчик
+ *  	и сбрасывают сдвиг изображения, сдвиг курсора меняет счётчик
+ *  	на 1, сдвиг изображения -- LCD_HandleTypeDef::Shift. Set CGRAM Address переводит
+ *  	счётчик в CGRAM (адрес DDRAM неизвестен). Entry Mode Set,
+ *  	Display On/Off Control и Function Set запоминаются в теневых
+ *  	регистрах дескриптора; от бита I/D зависит направление после записи
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] cmd  код команды
  *  @return None
  */
-static void s_transport_init (void)
+static void s_track_command (LCD_HandleTypeDef *hlcd, uint8_t cmd)
 {
-	// s_send_byte(0);
-	SRCLK_GPIO_Port->BSRR = (SRCLK_Pin << 0x10); // Сбросить строб RSCLK (11) 74HC595
-	RCLK_GPIO_Port->BSRR = (RCLK_Pin << 0x10); // Сбросить строб LATCH (12) 74HC595
-	SER_GPIO_Port->BSRR = (SER_Pin << 0x10);   // Сбросить строб DATA  (14) 74HC595
+	if ((cmd & 0xFC) == 0x04)
+		hlcd->EntryMode = cmd;
+	else if ((cmd & 0xF8) == 0x08)
+		hlcd->DisplayControl = cmd;
+	else if ((cmd & 0xE0) == 0x20)
+		hlcd->FunctionSet = cmd;
+	else if ((cmd & 0xF8) == 0x18)
+		s_shift_step(hlcd, !(cmd & 0x04)); // Сдвиг изображения, R/L
+	if (cmd == 0x01)
+		hlcd->EntryMode |= 0x02; // Очистка устанавливает I/D
+	if ((cmd & 0xFE) == 0x02 || cmd == 0x01)
+		hlcd->Shift = 0;
+	if (cmd & 0xC0)
+		hlcd->Cgram = !(cmd & 0x80);
+	else if ((cmd & 0xFE) == 0x02 || cmd == 0x01)
+		hlcd->Cgram = 0; // Счётчик снова в DDRAM
+	for (uint8_t k = 0; k < 2; k ++)
+	{
+		if (!(hlcd->Enable & (1 << k)))
+			continue;
+		if (cmd & 0x80)
+			hlcd->Counter[k] = cmd & 0x7F;
+		else if (cmd & 0x40)
+			hlcd->Counter[k] = LCD_NO_ADDRESS;
+		else if ((cmd & 0xF8) == 0x10)
+			hlcd->Counter[k] = s_counter_step(hlcd, hlcd->Counter[k], cmd & 0x04); // Сдвиг курсора, R/L
+		else if ((cmd & 0xFE) == 0x02 || cmd == 0x01)
+			hlcd->Counter[k] = 0;
+	}
 }
 
-/** @brief Отправляет байт, как команду (Линия RS не стробируется)
+/** @brief Учитывает запись данных в счётчике адреса выбранных контроллеров
  *  @note
- *  	Общая для всех видов траспорта.
- *  	(Вызывается общей функцией LCD_SendData)
- *  		RS_Bit -- не стробируется
- *  		E_Bit  -- стробирует передачу байта/полубайта
- *  	Для 4-битного режима: старший квартет -- данные, младший -- управляющие биты (E, RS, RW)
- *  	Прокси/заглушка для выбора между 8/4 бит и отправки команды без стробирования RS
- *  @param data (uint8_t) данные для отправки
+ *  	С битом S Entry Mode Set запись в DDRAM сдвигает и изображение,
+ *  	запись в CGRAM -- нет
+ *  @param [in] hlcd дескриптор дисплея
  *  @return None
  */
-static void s_send_command (uint8_t data)
+static void s_track_data (LCD_HandleTypeDef *hlcd)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-	s_send_2x4bit(data, 0); // Отправить команду, разбив на два квартета в старшем полубайте
-#elif (LCD_DATA_WITH == LCD_DATA_WIDTH_BYTE)
-#error "8 битный режим передачи данных для 74HC595 не реализован"
-#endif
+	if ((hlcd->EntryMode & 0x01) && !hlcd->Cgram)
+		s_shift_step(hlcd, hlcd->EntryMode & 0x02);
+	for (uint8_t k = 0; k < 2; k ++)
+	{
+		if (hlcd->Enable & (1 << k))
+			hlcd->Counter[k] = s_counter_step(hlcd, hlcd->Counter[k], hlcd->EntryMode & 0x02);
+	}
 }
 
-/** @brief Отправляет байт, как данные (Линия RS стробируется)
+/** @brief Отправляет байт, как команду (Линия RS не стробируется)
  *  @note
- *  	Должна быть определена во всех видах транспорта
- *  	(Вызывается общей функцией LCD_SendCommand)
- *  	RS_Bit -- стробируется
- *  	E_Bit  -- стробирует передачу байта/полубайта
- *  	В 4-битном режиме старший квартет -- данные, младший -- управляющие биты (E, RS)
- *  @param data (uint8_t)
+ *  	Пины:
+ *  	RS_Pin -- не стробируется
+ *  	E_Pin  -- стробируется
+ *  	Отправку выполняет транспорт дисплея.
+ *  	В асинхронном режиме команда только ставится в очередь
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] cmd  код команды
  *  @return None
  */
-static void s_send_data (uint8_t data)
+void LCD_SendCommand(LCD_HandleTypeDef *hlcd, uint8_t cmd)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-	s_send_2x4bit(data, RS_MSK); // Отправить данные разбив два квартета (в старшем полубайте)
-#elif (LCD_DATA_WITH == LCD_DATA_WIDTH_BYTE)
-#error "8 битный режим передачи данных для 74HC595 не реализован"
+	s_track_command (hlcd, cmd);
+#if (LCD_ASYNC_MODE != 0)
+	s_async_push (OP_TARGET(hlcd) | OP_COMMAND | cmd);
+#else
+	LCD_WaitReady (hlcd, hlcd->Enable);
+	hlcd->Transport->SendCommand (hlcd, cmd);
+	s_mark_busy (hlcd, LCD_InstrClassify(cmd));
 #endif
 }
 
-/** @brief Отправляет 8 бит со стробированием E и add (если != 0)
+/** @brief Отправляет байт, как данные (Линия RS стробируется)
  *  @note
- *  	Отправляет 8 бит вне зависимости от режима передачи 8/4 бита данных
- *  	Стробит передачу при помощи E_Bit и если add != 0, содержимым add
- *  	add передавать уже со смещением (маска, MSK)
- *  @param
- *	@return None
+ *  	Пины:
+ *  	RS_Pin -- стробируется
+ *  	E_Pin  -- стробируется
+ *  	Отправку выполняет транспорт дисплея.
+ *  	В асинхронном режиме байт только ставится в очередь
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт данных
+ *  @return None
  */
-static void s_send_8bit (uint8_t data, uint8_t add)
+void LCD_SendData (LCD_HandleTypeDef *hlcd, uint8_t data)
 {
-	s_transport_byte(data | BKL_MSK | EN_MSK | add);
-	s_transport_byte(data | BKL_MSK);
+	s_track_data (hlcd);
+#if (LCD_ASYNC_MODE != 0)
+	s_async_push (OP_TARGET(hlcd) | OP_DATA | data);
+#else
+	LCD_WaitReady (hlcd, hlcd->Enable);
+	hlcd->Transport->SendData (hlcd, data);
+	s_mark_busy (hlcd, LCD_INSTR_DATA);
+#endif
 }
 
-/** @brief Отправляет байт в 4-битном режиме передачи данных
+/** @brief Пауза в последовательности команд
  *  @note
- *  	В режиме данных 4 бита разбивает данные на 2 байта
- *  		в которых:
- *  			1. старший квартет -- данные,
- *  			2. младший квартет -- управляющие биты (LCD1602)
- *  	add может содержать
- *  		E_Bit  -- Строб передачи данных
- *  		RS_Bit -- Строб передачи команды
- *  		RW_Bit -- Строб записи в память (например, символа)
- *  	D0, D1, D2, D3, D4, D5, D6, D7 -- для 8битной передачи
- *  	D4, D5, D6, D7                 -- для 4битной передачи
+ *  	Нужна при инициализации дисплея. В асинхронном режиме пауза
+ *  	ставится в очередь и не блокирует вызывающего
+ *  @param [in] ms пауза, мс
  *  @return None
  */
-static void s_send_2x4bit (uint8_t data, uint8_t add)
+void LCD_WaitMs (uint32_t ms)
 {
-	// Отправить содержимое старшего квартета данных
-	// и установить добавочные данные в младший полубит
-    s_send_8bit((data) & 0xF0, add);
-    // Отправить содержимое младшего квартета данных в старшем квартете
-    // и установить добавочные данные в младший полубит
-    s_send_8bit((data << 4) & 0xF0, add);
+#if (LCD_ASYNC_MODE != 0)
+	while (ms)
+	{
+		uint32_t part = (ms > OP_DELAY_MAX) ? OP_DELAY_MAX : ms;
+		s_async_push (OP_DELAY | part);
+		ms -= part;
+	}
+#else
+	HAL_Delay(ms);
+#endif
 }
 
-/** @brief Устанавливает сигнал на пине 74HC595 SRCLK (11)
+/** @brief Проверка, что очередь асинхронного режима ещё не отправлена
  *  @note
- *		Функция реализована для транспорта 74HC595
- *	@return None
+ *  	Очередь общая для всех дисплеев
+ *  @return 1 -- в очереди есть операции или последняя ещё выполняется, 0 -- дисплей свободен
  */
-static void s_set_srclk(void)
+uint8_t LCD_IsBusy (void)
 {
-	s_stupid_delay(50); // Подождать 50 циклов
-	SRCLK_GPIO_Port->BSRR = (SRCLK_Pin); // Установить пин SRCLK
-	s_stupid_delay(50); // Подождать 50 циклов
-	SRCLK_GPIO_Port->BSRR = (SRCLK_Pin << 0x10); // Сбросить пин SRCLK
+#if (LCD_ASYNC_MODE != 0)
+	return (s_queue_head != s_queue_tail) || !s_async_idle;
+#else
+	return 0;
+#endif
 }
 
-/** @brief отправка байта/полубайта через выбранный транспорт
+/** @brief Начало кадра
  *  @note
- *  	Должна быть реализована во всех реализация транспорта
- *  	Транспорты:
- *  		1. Пины 4/8-бит + Управляющие пины
- *  		2. 74HC595 данные 4-бит
- *  		3. PCF8574T данные 4-бит
- *  	Режим работы:
- *  		1. Запуск клок-сигнала для передачи битов (c 1)
- *  		2. Передача по дата-каналу 0/1
- *  		3. После завершения байта взвести защёлку (LATCH)
- *  	Пины подключены в последовательности
- *  		QD -> D4
- *  		QE -> D5
- *  		QF -> D6
- *  		QH -> D7
- *  	Отправка идёт с 7 по 0 бит
+ *  	Если транспорт не накапливает кадры, каждая инструкция
+ *  	кадра отправляется сразу через LCD_SendCommand/LCD_SendData.
+ *  	Кадр транспорта сам выдерживает время выполнения своих
+ *  	инструкций, поэтому сначала дожидаются отправленные до него.
+ *  	Кадр идёт мимо асинхронной очереди (у PCF8574T без DMA --
+ *  	блокирующие транзакции через тот же I2C), поэтому
+ *  	в асинхронном режиме сначала дожидается отправка очереди
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
  */
-static void s_transport_byte (uint8_t data)
+void LCD_FrameBegin (LCD_HandleTypeDef *hlcd)
 {
-	RCLK_GPIO_Port->BSRR = RCLK_Pin << 0x10;
-	uint8_t cnt = 8; // Счётчик бит
-	s_set_srclk ();
-	while(cnt --) // Счёт от 7 до 0
+	LCD_WaitReady(hlcd, LCD_ENABLE_BOTH);
+	if (hlcd->Transport->FrameBegin)
 	{
-		SER_GPIO_Port->BSRR  = ((data >> cnt) & 1) ? (SER_Pin) : (SER_Pin << 0x10);
-		s_set_srclk ();
+		while (LCD_IsBusy())
+			; // Очередь TIM7 ещё отправляет команды, отправленные до кадра
+		hlcd->Transport->FrameBegin(hlcd);
 	}
-	RCLK_GPIO_Port->BSRR = (RCLK_Pin); // Установить защёлку и открыть установленные данные на передачу на пинах QA-QH 74HC595
-	SER_GPIO_Port->BSRR  = (SER_Pin << 0x10); // Сбросить пин данных в 0
-	s_stupid_delay(50);
 }
-#elif LCD_DATA_TRANSPORT == LCD_DATA_PCF8574T
-
-#include "i2c.h"
-
-#define PCF8574T_I2C_ADDR 0x27
-#define RS_Bit  0 ///?> Если на пине RS -- 0, данные воспринимаются как команда, если 1 - как символы для вывода
-#define RW_Bit  1 ///?> Пин записи данных в память LCD1602
-#define EN_Bit  2 ///?> Строб данных на пинах LCD1602
-#define BKL_Bit 3 ///?> Пин подсветки
-
-
-#define PCF8574T_I2C_ADDR_MSK (PCF8574T_I2C_ADDR << 1) ///?> Адрес I2C, сдвинутый на 1 бит влево (HAL работает с I2C-адресами, сдвинутыми на 1 бит влево)
-#define RS_MSK    (1 << RS_Bit)  ///?> Маска строба данных/команды
-#define RW_MSK    (1 << RW_Bit)  ///?> Строб записи данных в память LCD1602
-#define EN_MSK    (1 << EN_Bit)  ///?> Строб передачи данных на GPIO дисплея LCD1602
-#define BKL_MSK   (1 << BKL_Bit) ///?> Управление подсветкой (BackLight)
-
-#define HI2C_DEVICE_HANDLER hi2c1 ///?> идентификатор I2C
-
-static void s_transport_byte (uint8_t data);
-static void s_send_8bit      (uint8_t data, uint8_t add);
-static void s_send_2x4bit    (uint8_t data, uint8_t add);
 
-/** @brief Отправляет байт, как данные (Линия RS стробируется)
- *  @note
- *  	Должна быть определена во всех видах транспорта
- *  	(Вызывается общей функцией LCD_SendCommand)
- *  	RS_Bit -- стробируется
- *  	E_Bit  -- стробирует передачу байта/полубайта
- *  	В 4-битном режиме старший квартет -- данные, младший -- управляющие биты (E, RS)
- *  @param data (uint8_t)
+/** @brief Добавляет в кадр команду
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] cmd  код команды
  *  @return None
  */
-static void s_send_data (uint8_t data)
+void LCD_FrameCommand (LCD_HandleTypeDef *hlcd, uint8_t cmd)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-	s_send_2x4bit(data, RS_MSK); // Отправить данные разбив два квартета (в старшем полубайте)
-#elif (LCD_DATA_WITH == LCD_DATA_WIDTH_BYTE)
-#error "8 битный режим передачи данных для 74HC595 не реализован"
-#endif
+	if (hlcd->Transport->FrameCommand)
+	{
+		s_track_command(hlcd, cmd);
+		hlcd->Transport->FrameCommand(hlcd, cmd);
+	}
+	else
+		LCD_SendCommand(hlcd, cmd);
 }
 
-/** @brief Отправляет байт, как команду (Линия RS не стробируется)
- *  @note
- *  	Общая для всех видов траспорта.
- *  	(Вызывается общей функцией LCD_SendData)
- *  		RS_Bit -- не стробируется
- *  		EN_Bit  -- стробирует передачу байта/полубайта
- *  	Для 4-битного режима: старший квартет -- данные, младший -- управляющие биты (E, RS, RW)
- *  	Прокси/заглушка для выбора между 8/4 бит и отправки команды без стробирования RS
- *  @param data (uint8_t) данные для отправки
+/** @brief Добавляет в кадр байт данных
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт данных
  *  @return None
  */
-static void s_send_command (uint8_t data)
+void LCD_FrameData (LCD_HandleTypeDef *hlcd, uint8_t data)
 {
-#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
-	s_send_2x4bit(data, 0); // Отправить команду, разбив на два квартета в старшем полубайте
-#elif (LCD_DATA_WITH == LCD_DATA_WIDTH_BYTE)
-#error "8 битный режим передачи данных для 74HC595 не реализован"
-#endif
+	if (hlcd->Transport->FrameData)
+	{
+		s_track_data(hlcd);
+		hlcd->Transport->FrameData(hlcd, data);
+	}
+	else
+		LCD_SendData(hlcd, data);
 }
 
-static void s_transport_init (void)
+/** @brief Конец кадра
+ *  @note
+ *  	Транспорт с DMA запускает вывод и сразу возвращается,
+ *  	LCD_FrameCompleteCallback вызывается по окончании (из прерывания)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+void LCD_FrameEnd (LCD_HandleTypeDef *hlcd)
 {
-
+	if (hlcd->Transport->FrameEnd)
+		hlcd->Transport->FrameEnd(hlcd);
+	else
+		LCD_FrameCompleteCallback(hlcd);
 }
 
-/** @brief Отправляет 8 бит со стробированием E и add (если != 0)
+/** @brief Проверка, что следующий кадр дисплея будет ждать вывода предыдущих
  *  @note
- *  	Отправляет 8 бит вне зависимости от режима передачи 8/4 бита данных
- *  	Стробит передачу при помощи E_Bit и если add != 0, содержимым add
- *  	add передавать уже со смещением (маска, MSK)
- *  @param
- *	@return None
+ *  	Транспорт с одним буфером кадра занят, пока кадр выводится,
+ *  	с двойным буфером (PCF8574T) -- пока оба буфера ждут вывода
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- дисплей занят, 0 -- свободен
  */
-static void s_send_8bit (uint8_t data, uint8_t add)
+uint8_t LCD_FrameBusy (LCD_HandleTypeDef *hlcd)
 {
-	s_transport_byte(data | BKL_MSK | EN_MSK | add);
-	s_transport_byte(data | BKL_MSK);
+	if (hlcd->Transport->FrameBusy)
+		return hlcd->Transport->FrameBusy(hlcd);
+	return LCD_IsBusy();
 }
 
-/** @brief Отправляет байт в 4-битном режиме передачи данных
+/** @brief Время передачи одного байта (команды или символа) дисплею
  *  @note
- *  	В режиме данных 4 бита разбивает данные на 2 байта
- *  		в которых:
- *  			1. старший квартет -- данные,
- *  			2. младший квартет -- управляющие биты (LCD1602)
- *  	add может содержать
- *  		E_Bit  -- Строб передачи данных
- *  		RS_Bit -- Строб передачи команды
- *  		RW_Bit -- Строб записи в память (например, символа)
- *  	D0, D1, D2, D3, D4, D5, D6, D7 -- для 8битной передачи
- *  	D4, D5, D6, D7                 -- для 4битной передачи
- *  @return None
+ *  	Модель стоимости вывода: без времени выполнения инструкции
+ *  	контроллером (lcd_timing.h). Транспорт без своей оценки
+ *  	тратит на байт цикл E, в 4-битном режиме -- два
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return время, нс
  */
-static void s_send_2x4bit (uint8_t data, uint8_t add)
+uint32_t LCD_ByteTimeNs (LCD_HandleTypeDef *hlcd)
 {
-	// Отправить содержимое старшего квартета данных
-	// и установить добавочные данные в младший полубит
-    s_send_8bit((data) & 0xF0, add);
-    // Отправить содержимое младшего квартета данных в старшем квартете
-    // и установить добавочные данные в младший полубит
-    s_send_8bit((data << 4) & 0xF0, add);
+	if (hlcd->Transport->ByteTimeNs)
+		return hlcd->Transport->ByteTimeNs(hlcd);
+	return (hlcd->Transport->Width == LCD_DATA_WIDTH_HALF_BYTE) ? 2U * LCD_T_CYCE_NS : LCD_T_CYCE_NS;
 }
 
-/** @brief Отправка байта
- *	@note
- *	@param [in] data -- байт для передачи
- *	@return None
+/** @brief Кадр выведен
+ *  @note
+ *  	Слабое определение, переопределяется приложением.
+ *  	При выводе через DMA вызывается из прерывания
+ *  @param [in] hlcd дескриптор дисплея, кадр которого выведен
+ *  @return None
  */
-static void s_transport_byte (uint8_t data)
+__weak void LCD_FrameCompleteCallback (LCD_HandleTypeDef *hlcd)
 {
-	// Проверка готовности устройства для отправки данных
-	if (HAL_I2C_IsDeviceReady(& HI2C_DEVICE_HANDLER, PCF8574T_I2C_ADDR_MSK, 10, 1000) != HAL_OK)
-	{
-		Error_Handler();
-	}
-
-	HAL_I2C_Master_Transmit(& HI2C_DEVICE_HANDLER, PCF8574T_I2C_ADDR_MSK, &data, 1, 1000);
+	(void) hlcd;
 }
-#endif
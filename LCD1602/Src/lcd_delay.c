@@ -0,0 +1,88 @@
+/*
+ * lcd_delay.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "main.h"
+#include "lcd_delay.h"
+
+static uint32_t s_cycles_per_us = 0; ///?> Тактов ядра в микросекунде (по SystemCoreClock)
+
+/** @brief Запуск счётчика тактов DWT->CYCCNT
+ *  @note
+ *  	Вызывать после SystemClock_Config: число тактов в микросекунде
+ *  	берётся из SystemCoreClock в момент инициализации.
+ *  	Счётчик не зависит ни от уровня оптимизации, ни от задержек
+ *  	флеш-памяти, в отличие от пустого цикла
+ *  @return None
+ */
+void LCD_DelayInit (void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // Включить блок трассировки (DWT)
+	DWT->CYCCNT = 0;
+	DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;           // Запустить счётчик тактов
+	s_cycles_per_us = SystemCoreClock / 1000000U;
+}
+
+/** @brief Ожидание заданного числа тактов ядра
+ *  @note
+ *  	Разность беззнаковая, поэтому переполнение CYCCNT учитывается
+ *  @param [in] cycles число тактов
+ *  @return None
+ */
+void LCD_DelayCycles (uint32_t cycles)
+{
+	uint32_t start = DWT->CYCCNT;
+	while ((DWT->CYCCNT - start) < cycles)
+		;
+}
+
+/** @brief Ожидание в наносекундах
+ *  @note
+ *  	Время округляется вверх до такта ядра (10 нс на 100 МГц).
+ *  	Накладные расходы вызова только увеличивают задержку,
+ *  	поэтому минимальные времена спецификации выдерживаются
+ *  @param [in] ns время ожидания, нс
+ *  @return None
+ */
+void LCD_DelayNs (uint32_t ns)
+{
+	LCD_DelayCycles((ns * s_cycles_per_us + 999U) / 1000U);
+}
+
+/** @brief Ожидание в микросекундах
+ *  @param [in] us время ожидания, мкс
+ *  @return None
+ */
+void LCD_DelayUs (uint32_t us)
+{
+	LCD_DelayCycles(us * s_cycles_per_us);
+}
+
+/** @brief Момент отправки инструкции
+ *  @note
+ *  	Текущее значение DWT->CYCCNT. Позволяет не ждать сразу,
+ *  	а проверить время выполнения перед следующим обращением
+ *  @return значение счётчика тактов
+ */
+uint32_t LCD_DelayStamp (void)
+{
+	return DWT->CYCCNT;
+}
+
+/** @brief Ожидание, пока с момента LCD_DelayStamp не пройдёт заданное время
+ *  @note
+ *  	Прошедшее время -- беззнаковая разность, поэтому давно
+ *  	прошедший срок не ждётся, сколько бы дисплей ни простаивал
+ *  	(кроме окна длиной us раз в период CYCCNT, 43 с на 100 МГц)
+ *  @param [in] start значение счётчика тактов от LCD_DelayStamp
+ *  @param [in] us    время от момента start, мкс
+ *  @return None
+ */
+void LCD_DelaySince (uint32_t start, uint32_t us)
+{
+	uint32_t cycles = us * s_cycles_per_us;
+	while ((DWT->CYCCNT - start) < cycles)
+		;
+}
@@ -0,0 +1,168 @@
+/*
+ * lcd_glyph.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd_glyph.h"
+
+/** @brief Пересчитывает ссылки на ячейки CGRAM по теневому буферу
+ *  @note
+ *  	Коды 0x00-0x0F -- знаки CGRAM (0x08-0x0F -- зеркало).
+ *  	Стёртые LCD_SoftClear ячейки станут пробелами и не считаются
+ *  @param [in] hgc дескриптор кэша
+ *  @return None
+ */
+static void s_count_refs (LCD_GlyphCacheTypeDef *hgc)
+{
+	LCD_HandleTypeDef *hlcd = hgc->Display;
+	for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot ++)
+		hgc->Refs[slot] = 0;
+	for (uint8_t row = 0; row < hlcd->Geometry->Rows; row ++)
+	{
+		for (uint8_t col = 0; col < hlcd->Geometry->Cols; col ++)
+		{
+			uint8_t ch = hlcd->Frame[row][col];
+			if ((ch & 0xF0) == 0 && !(hlcd->Blank[row][col >> 3] & (1 << (col & 0x07))))
+				hgc->Refs[ch & 0x07] ++;
+		}
+	}
+}
+
+/** @brief Выбирает ячейку CGRAM для нового знака
+ *  @note
+ *  	Свободная ячейка, иначе давно не использованная (LRU) из тех,
+ *  	на которые не ссылается теневой буфер
+ *  @param [in] hgc дескриптор кэша
+ *  @return № ячейки, LCD_GLYPH_SLOTS -- все знаки на экране
+ */
+static uint8_t s_victim (LCD_GlyphCacheTypeDef *hgc)
+{
+	uint8_t victim = LCD_GLYPH_SLOTS;
+	for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot ++)
+	{
+		if (hgc->Slot[slot] == LCD_GLYPH_NONE)
+			return slot;
+		if (hgc->Refs[slot] == 0 && (victim == LCD_GLYPH_SLOTS || hgc->Used[slot] < hgc->Used[victim]))
+			victim = slot;
+	}
+	return victim;
+}
+
+/** @brief Инициализация кэша знаков
+ *  @note
+ *  	Содержимое CGRAM после включения не определено, поэтому все
+ *  	ячейки считаются свободными
+ *  @param [in] hgc     дескриптор кэша
+ *  @param [in] hlcd    дисплей (после LCD_Init)
+ *  @param [in] bitmaps таблица растров: 8 строк по 5 младших бит на знак
+ *  @param [in] count   число знаков в таблице
+ *  @return None
+ */
+void LCD_GlyphInit (LCD_GlyphCacheTypeDef *hgc, LCD_HandleTypeDef *hlcd,
+                    const uint8_t (*bitmaps)[LCD_GLYPH_ROWS], uint16_t count)
+{
+	hgc->Display = hlcd;
+	hgc->Bitmaps = bitmaps;
+	hgc->Count   = count;
+	for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot ++)
+	{
+		hgc->Slot[slot] = LCD_GLYPH_NONE;
+		hgc->Used[slot] = 0;
+		hgc->Refs[slot] = 0;
+	}
+	hgc->Upload = 0;
+	hgc->Tick   = 0;
+	hgc->Hits   = 0;
+	hgc->Misses = 0;
+}
+
+/** @brief Записывает знак в теневой буфер в позицию курсора
+ *  @note
+ *  	При промахе знак получает ячейку CGRAM (s_victim), растр
+ *  	загрузится в LCD_GlyphFlush перед отправкой DDRAM. Если все
+ *  	8 ячеек заняты знаками с экрана, знак не записывается
+ *  @param [in] hgc дескриптор кэша
+ *  @param [in] id  ID знака (индекс в таблице растров)
+ *  @return 1 -- знак записан, 0 -- нет свободной ячейки или неверный ID
+ */
+uint8_t LCD_GlyphPut (LCD_GlyphCacheTypeDef *hgc, uint16_t id)
+{
+	if (id >= hgc->Count)
+		return 0;
+	uint8_t slot = 0;
+	while (slot < LCD_GLYPH_SLOTS && hgc->Slot[slot] != id)
+		slot ++;
+	if (slot < LCD_GLYPH_SLOTS)
+	{
+		hgc->Hits ++;
+	}
+	else
+	{
+		s_count_refs(hgc);
+		slot = s_victim(hgc);
+		if (slot >= LCD_GLYPH_SLOTS)
+			return 0;
+		hgc->Slot[slot] = id;
+		hgc->Upload |= (uint8_t) (1 << slot);
+		hgc->Misses ++;
+	}
+	hgc->Used[slot] = ++ hgc->Tick;
+	char ch = (char) (LCD_GLYPH_CODE + slot);
+	LCD_SendString(hgc->Display, &ch, 1);
+	return 1;
+}
+
+/** @brief Загружает новые знаки и отправляет теневой буфер
+ *  @note
+ *  	Растры ждущих загрузки ячеек уходят одним кадром, соседние
+ *  	ячейки -- без повторной установки адреса CGRAM. При вводе справа
+ *  	налево (LCD_LeftToRight) на время загрузки включается I/D = 1,
+ *  	иначе растр лёг бы задом наперёд в предыдущую ячейку. Загруженные
+ *  	знаки больше не отправляются. Затем -- LCD_Flush (адрес DDRAM
+ *  	после записи CGRAM неизвестен и устанавливается заново).
+ *  	У 40x4 знаки загружаются в оба контроллера сразу
+ *  @param [in] hgc дескриптор кэша
+ *  @return None
+ */
+void LCD_GlyphFlush (LCD_GlyphCacheTypeDef *hgc)
+{
+	LCD_HandleTypeDef *hlcd = hgc->Display;
+	if (hgc->Upload)
+	{
+		uint8_t next = LCD_GLYPH_SLOTS; // Ячейка, на которую указывает счётчик CGRAM
+		uint8_t entry = hlcd->EntryMode;
+		LCD_FrameBegin(hlcd);
+		if (!(entry & 0x02))
+			LCD_FrameCommand(hlcd, entry | 0x02); // Растр пишется с увеличением счётчика (I/D = 1)
+		for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot ++)
+		{
+			if (!(hgc->Upload & (1 << slot)))
+				continue;
+			if (slot != next)
+				LCD_FrameCommand(hlcd, (uint8_t) (0x40 | (slot << 3)));
+			for (uint8_t row = 0; row < LCD_GLYPH_ROWS; row ++)
+				LCD_FrameData(hlcd, hgc->Bitmaps[hgc->Slot[slot]][row] & 0x1F);
+			next = slot + 1;
+		}
+		if (!(entry & 0x02))
+			LCD_FrameCommand(hlcd, entry); // Вернуть направление ввода
+		LCD_FrameEnd(hlcd);
+		hgc->Upload = 0;
+	}
+	LCD_Flush(hlcd);
+}
+
+/** @brief Статистика кэша знаков
+ *  @param [in]  hgc    дескриптор кэша
+ *  @param [out] hits   попаданий (NULL -- не нужно)
+ *  @param [out] misses промахов (NULL -- не нужно)
+ *  @return None
+ */
+void LCD_GlyphStats (LCD_GlyphCacheTypeDef *hgc, uint32_t *hits, uint32_t *misses)
+{
+	if (hits)
+		*hits = hgc->Hits;
+	if (misses)
+		*misses = hgc->Misses;
+}
@@ -0,0 +1,185 @@
+/*
+ * lcd_marquee.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd_marquee.h"
+
+#include <string.h>
+
+#if (LCD_MARQUEE_LEN != 40)
+#error "LCD_MARQUEE_LEN -- длина строки DDRAM двухстрочного режима (40)"
+#endif
+
+/** @brief Проверка, что строки дисплея можно прокручивать сдвигом изображения
+ *  @note
+ *  	Сдвиг изображения двигает все строки контроллера сразу, поэтому
+ *  	каждая видимая строка должна занимать свою строку DDRAM целиком:
+ *  	16x2, 20x2, 40x2. У 16x4/20x4 строки 3-4 -- продолжение строк 1-2,
+ *  	у 16x1 с разбиением -- половины одной строки, у 40x4 -- два контроллера
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- можно, 0 -- только перезапись ячеек
+ */
+static uint8_t s_hardware (LCD_HandleTypeDef *hlcd)
+{
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
+	return geo->Rows == 2 && geo->Lines == 2 && geo->SplitCol == 0 && geo->E2Row == 0;
+}
+
+/** @brief Переносит видимое окно кольцевого текста в теневой буфер
+ *  @param [in] hmq  дескриптор бегущих строк
+ *  @param [in] row  № строки
+ *  @param [in] sent 1 -- окно уже на экране (загрузка, сдвиг изображения),
+ *                   0 -- изменённые ячейки отправит LCD_Flush
+ *  @return None
+ */
+static void s_window (LCD_MarqueeTypeDef *hmq, uint8_t row, uint8_t sent)
+{
+	LCD_HandleTypeDef *hlcd = hmq->Display;
+	for (uint8_t col = 0; col < hlcd->Geometry->Cols; col ++)
+	{
+		uint8_t ch  = hmq->Text[row][(col + hmq->Offset[row]) % LCD_MARQUEE_LEN];
+		uint8_t bit = (uint8_t) (1 << (col & 0x07));
+		if (hlcd->Blank[row][col >> 3] & bit)
+		{
+			hlcd->Blank[row][col >> 3] &= (uint8_t) ~bit;
+			if (hlcd->Frame[row][col] == ch)
+				hlcd->Dirty[row][col >> 3] &= (uint8_t) ~bit; // На экране уже этот символ
+		}
+		if (sent)
+			hlcd->Dirty[row][col >> 3] &= (uint8_t) ~bit;
+		else if (hlcd->Frame[row][col] != ch)
+			hlcd->Dirty[row][col >> 3] |= bit;
+		hlcd->Frame[row][col] = ch;
+	}
+}
+
+/** @brief Проверка, что видимое окно строки никто не перезаписал
+ *  @note
+ *  	LCD_Clear, LCD_SendString по бегущей строке меняют DDRAM мимо
+ *  	бегущих строк, после них сдвиг изображения показал бы чужой текст
+ *  @param [in] hmq дескриптор бегущих строк
+ *  @param [in] row № строки
+ *  @return 1 -- окно на месте, 0 -- строку нужно перезаписывать
+ */
+static uint8_t s_in_place (LCD_MarqueeTypeDef *hmq, uint8_t row)
+{
+	LCD_HandleTypeDef *hlcd = hmq->Display;
+	for (uint8_t col = 0; col < hlcd->Geometry->Cols; col ++)
+	{
+		if ((hlcd->Dirty[row][col >> 3] & (1 << (col & 0x07))) ||
+			hlcd->Frame[row][col] != hmq->Text[row][(col + hmq->Offset[row]) % LCD_MARQUEE_LEN])
+			return 0;
+	}
+	return 1;
+}
+
+/** @brief Инициализация бегущих строк дисплея
+ *  @param [in] hmq  дескриптор бегущих строк
+ *  @param [in] hlcd дисплей (после LCD_Init)
+ *  @return None
+ */
+void LCD_MarqueeInit (LCD_MarqueeTypeDef *hmq, LCD_HandleTypeDef *hlcd)
+{
+	hmq->Display = hlcd;
+	memset(hmq->Text, ' ', sizeof(hmq->Text));
+	memset(hmq->Offset, 0, sizeof(hmq->Offset));
+	hmq->Active = 0;
+	hmq->Loaded = 0;
+}
+
+/** @brief Задаёт текст бегущей строки
+ *  @note
+ *  	Текст (до LCD_MARQUEE_LEN символов) дополняется пробелами
+ *  	и прокручивается по кольцу. Если дисплей допускает сдвиг
+ *  	изображения (s_hardware) и ввод идёт слева направо без сдвига,
+ *  	вся строка DDRAM, включая невидимые ячейки, записывается сразу:
+ *  	с учётом текущего сдвига, видимая колонка 0 -- начало текста.
+ *  	Иначе видимые ячейки отправит LCD_Flush
+ *  @param [in] hmq  дескриптор бегущих строк
+ *  @param [in] row  № строки (начинается с 0)
+ *  @param [in] str  указатель на строку
+ *  @param [in] size размер строки в байтах
+ *  @return None
+ */
+void LCD_MarqueeSetText (LCD_MarqueeTypeDef *hmq, uint8_t row, char *str, uint8_t size)
+{
+	LCD_HandleTypeDef *hlcd = hmq->Display;
+	if (row >= hlcd->Geometry->Rows)
+		return;
+	uint8_t bit = (uint8_t) (1 << row);
+	memset(hmq->Text[row], ' ', LCD_MARQUEE_LEN);
+	for (uint8_t i = 0; i < size && i < LCD_MARQUEE_LEN && str[i]; i ++)
+		hmq->Text[row][i] = (uint8_t) str[i];
+	hmq->Offset[row] = 0;
+	hmq->Active |= bit;
+	hmq->Loaded &= (uint8_t) ~bit;
+	if (s_hardware(hlcd) && (hlcd->EntryMode & 0x03) == 0x02)
+	{
+		// Адрес j строки DDRAM виден в колонке j - Shift
+		LCD_SendCommand(hlcd, 0x80 | hlcd->Geometry->RowOffset[row]);
+		for (uint8_t j = 0; j < LCD_MARQUEE_LEN; j ++)
+			LCD_SendData(hlcd, hmq->Text[row][(j + LCD_MARQUEE_LEN - hlcd->Shift) % LCD_MARQUEE_LEN]);
+		hmq->Loaded |= bit;
+	}
+	s_window(hmq, row, hmq->Loaded & bit);
+}
+
+/** @brief Останавливает бегущую строку
+ *  @note
+ *  	Видимый текст остаётся на месте, строка снова обычная
+ *  @param [in] hmq дескриптор бегущих строк
+ *  @param [in] row № строки (начинается с 0)
+ *  @return None
+ */
+void LCD_MarqueeStop (LCD_MarqueeTypeDef *hmq, uint8_t row)
+{
+	hmq->Active &= (uint8_t) ~(1 << row);
+	hmq->Loaded &= (uint8_t) ~(1 << row);
+}
+
+/** @brief Шаг прокрутки бегущих строк
+ *  @note
+ *  	Если прокручиваются все строки дисплея и строки DDRAM всех
+ *  	загружены (LCD_MarqueeSetText), отправляется одна команда сдвига
+ *  	изображения: 0x18 влево, 0x1C вправо. Иначе (строки прокручиваются
+ *  	по отдельности, часть строк неподвижна, геометрия не допускает
+ *  	сдвига) окна строк переписываются в теневой буфер, изменённые
+ *  	ячейки отправляет LCD_Flush. Такая строка теряет загрузку до
+ *  	следующего LCD_MarqueeSetText
+ *  @param [in] hmq  дескриптор бегущих строк
+ *  @param [in] rows маска прокручиваемых строк (бит 0 -- строка 0)
+ *  @param [in] left 1 -- текст движется влево, 0 -- вправо
+ *  @return None
+ */
+void LCD_MarqueeStep (LCD_MarqueeTypeDef *hmq, uint8_t rows, uint8_t left)
+{
+	LCD_HandleTypeDef *hlcd = hmq->Display;
+	uint8_t all = (uint8_t) ((1 << hlcd->Geometry->Rows) - 1);
+	uint8_t step = left ? 1 : LCD_MARQUEE_LEN - 1;
+	rows &= hmq->Active;
+	for (uint8_t row = 0; row < hlcd->Geometry->Rows; row ++)
+	{
+		if ((hmq->Loaded & (1 << row)) && !s_in_place(hmq, row))
+			hmq->Loaded &= (uint8_t) ~(1 << row);
+	}
+	if (rows == all && hmq->Loaded == all && s_hardware(hlcd))
+	{
+		LCD_SendCommand(hlcd, left ? 0x18 : 0x1C); // Сдвиг ведёт lcd_data_transport.c (LCD_HandleTypeDef::Shift)
+		for (uint8_t row = 0; row < hlcd->Geometry->Rows; row ++)
+		{
+			hmq->Offset[row] = (uint8_t) ((hmq->Offset[row] + step) % LCD_MARQUEE_LEN);
+			s_window(hmq, row, 1);
+		}
+		return;
+	}
+	for (uint8_t row = 0; row < hlcd->Geometry->Rows; row ++)
+	{
+		if (!(rows & (1 << row)))
+			continue;
+		hmq->Offset[row] = (uint8_t) ((hmq->Offset[row] + step) % LCD_MARQUEE_LEN);
+		hmq->Loaded &= (uint8_t) ~(1 << row);
+		s_window(hmq, row, 0);
+	}
+}
@@ -0,0 +1,148 @@
+/*
+ * lcd_page.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd_page.h"
+
+#include <string.h>
+
+#define PAGE_LINE 40 ///?> Длина строки DDRAM двухстрочного режима
+
+/** @brief Проверка, что у дисплея есть невидимая страница
+ *  @note
+ *  	Каждая строка дисплея -- своя строка DDRAM, и в ней помещаются
+ *  	две страницы: 16x2, 20x2. Иначе страницы не переключаются
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- есть, 0 -- нет
+ */
+static uint8_t s_paged (LCD_HandleTypeDef *hlcd)
+{
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
+	return geo->Rows == 2 && geo->Lines == 2 && geo->SplitCol == 0 && geo->E2Row == 0 &&
+	       2 * geo->Cols <= PAGE_LINE;
+}
+
+/** @brief Сдвиг изображения, при котором видна страница
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] page № страницы
+ *  @return LCD_HandleTypeDef::Shift
+ */
+static inline uint8_t s_page_shift (LCD_HandleTypeDef *hlcd, uint8_t page)
+{
+	return page ? (uint8_t) (PAGE_LINE - hlcd->Geometry->Cols) : 0;
+}
+
+/** @brief Запоминает содержимое видимой страницы по теневому буферу
+ *  @note
+ *  	Отправленные ячейки и стёртые LCD_SoftClear (на экране ещё
+ *  	символ из Frame) известны, остальные изменённые -- нет
+ *  @param [in] hpg дескриптор страниц
+ *  @return None
+ */
+static void s_capture_shown (LCD_PageTypeDef *hpg)
+{
+	LCD_HandleTypeDef *hlcd = hpg->Display;
+	for (uint8_t row = 0; row < hlcd->Geometry->Rows; row ++)
+	{
+		for (uint8_t col = 0; col < hlcd->Geometry->Cols; col ++)
+		{
+			uint8_t bit = (uint8_t) (1 << (col & 0x07));
+			hpg->Page[hpg->Shown][row][col] = hlcd->Frame[row][col];
+			if ((hlcd->Dirty[row][col >> 3] & bit) && !(hlcd->Blank[row][col >> 3] & bit))
+				hpg->Stale[hpg->Shown][row][col >> 3] |= bit;
+			else
+				hpg->Stale[hpg->Shown][row][col >> 3] &= (uint8_t) ~bit;
+		}
+	}
+}
+
+/** @brief Инициализация страниц дисплея
+ *  @note
+ *  	Видимой считается страница 0, содержимое невидимой неизвестно.
+ *  	После LCD_Clear (очищает обе страницы и возвращает сдвиг)
+ *  	нужно вызвать снова
+ *  @param [in] hpg  дескриптор страниц
+ *  @param [in] hlcd дисплей (после LCD_Init)
+ *  @return None
+ */
+void LCD_PageInit (LCD_PageTypeDef *hpg, LCD_HandleTypeDef *hlcd)
+{
+	hpg->Display = hlcd;
+	hpg->Shown   = 0;
+	memset(hpg->Stale, 0xFF, sizeof(hpg->Stale));
+}
+
+/** @brief Выводит теневой буфер через невидимую страницу
+ *  @note
+ *  	Ячейки, которые отличаются от невидимой страницы, пишутся в неё,
+ *  	пока видимая остаётся на экране, затем страницы меняются
+ *  	в том же кадре: на страницу 0 -- Return Home, на страницу 1 --
+ *  	Cols сдвигов изображения вправо (у HD44780 нет команды адреса
+ *  	начала изображения, сдвиг -- только на одну ячейку).
+ *  	Дальше LCD_Flush пишет в новую видимую страницу (сдвиг
+ *  	изображения учитывается в адресах). Без невидимой страницы
+ *  	и с автосдвигом (LCD_Autoscroll) -- обычный LCD_Flush. При вводе
+ *  	справа налево на время записи страницы включается I/D = 1
+ *  @param [in] hpg дескриптор страниц
+ *  @return None
+ */
+void LCD_PageFlip (LCD_PageTypeDef *hpg)
+{
+	LCD_HandleTypeDef *hlcd = hpg->Display;
+	const LCD_GeometryTypeDef *geo = hlcd->Geometry;
+	uint8_t entry = hlcd->EntryMode;
+	if (!s_paged(hlcd) || (entry & 0x01))
+	{
+		LCD_Flush(hlcd); // С автосдвигом каждая запись увела бы изображение со страницы
+		return;
+	}
+	if (hlcd->Shift != s_page_shift(hlcd, hpg->Shown))
+	{
+		// Сдвиг меняли мимо страниц (LCD_Clear, бегущая строка)
+		memset(hpg->Stale, 0xFF, sizeof(hpg->Stale));
+		hpg->Shown = (hlcd->Shift == s_page_shift(hlcd, 1));
+	}
+	if (hlcd->Shift == s_page_shift(hlcd, hpg->Shown))
+		s_capture_shown(hpg);
+	uint8_t next = !hpg->Shown;
+	uint8_t base = s_page_shift(hlcd, next);
+	LCD_FrameBegin(hlcd);
+	if (!(entry & 0x02))
+		LCD_FrameCommand(hlcd, entry | 0x02); // Страница пишется слева направо (I/D = 1)
+	for (uint8_t row = 0; row < geo->Rows; row ++)
+	{
+		for (uint8_t col = 0; col < geo->Cols; col ++)
+		{
+			uint8_t bit = (uint8_t) (1 << (col & 0x07));
+			uint8_t ch  = (hlcd->Blank[row][col >> 3] & bit) ? ' ' : hlcd->Frame[row][col];
+			if (!(hpg->Stale[next][row][col >> 3] & bit) && hpg->Page[next][row][col] == ch)
+				continue;
+			uint8_t address = (uint8_t) (geo->RowOffset[row] + base + col);
+			if (hlcd->Counter[0] != address)
+				LCD_FrameCommand(hlcd, 0x80 | address);
+			LCD_FrameData(hlcd, ch);
+			hpg->Page[next][row][col] = ch;
+			hpg->Stale[next][row][col >> 3] &= (uint8_t) ~bit;
+		}
+	}
+	if (!(entry & 0x02))
+		LCD_FrameCommand(hlcd, entry); // Вернуть направление ввода
+	if (next == 0 || hlcd->Shift != 0)
+		LCD_FrameCommand(hlcd, 0b00000010); // Return Home: сдвиг 0
+	if (next)
+	{
+		for (uint8_t i = 0; i < geo->Cols; i ++)
+			LCD_FrameCommand(hlcd, 0b00011100); // Сдвиг изображения вправо: Shift -> 40 - Cols
+	}
+	LCD_FrameEnd(hlcd);
+	hpg->Shown = next;
+	for (uint8_t row = 0; row < geo->Rows; row ++)
+	{
+		for (uint8_t col = 0; col < geo->Cols; col ++)
+			hlcd->Frame[row][col] = hpg->Page[next][row][col];
+	}
+	memset(hlcd->Dirty, 0, sizeof(hlcd->Dirty));
+	memset(hlcd->Blank, 0, sizeof(hlcd->Blank));
+}
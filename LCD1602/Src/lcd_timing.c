@@ -0,0 +1,98 @@
+/*
+ * lcd_timing.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "main.h"
+#include "lcd_timing.h"
+
+/// Времена выполнения инструкций по спецификациям, мкс (fosc = 270 КГц)
+#if (LCD_CONTROLLER == LCD_CONTROLLER_HD44780)
+#define T_CLEAR_US  1520 ///?> Очистка экрана
+#define T_HOME_US   1520 ///?> Возврат курсора в начало
+#define T_CMD_US    37   ///?> Остальные команды
+#define T_DATA_US   41   ///?> Запись данных (37 мкс + tADD 4 мкс)
+#elif (LCD_CONTROLLER == LCD_CONTROLLER_ST7066U)
+#define T_CLEAR_US  1520
+#define T_HOME_US   1520
+#define T_CMD_US    37
+#define T_DATA_US   43
+#elif (LCD_CONTROLLER == LCD_CONTROLLER_SPLC780D)
+#define T_CLEAR_US  1520
+#define T_HOME_US   1520
+#define T_CMD_US    37
+#define T_DATA_US   43
+#elif (LCD_CONTROLLER == LCD_CONTROLLER_KS0066)
+#define T_CLEAR_US  1530
+#define T_HOME_US   1530
+#define T_CMD_US    39
+#define T_DATA_US   43
+#else
+#error "Не выбран контроллер дисплея (LCD_CONTROLLER)"
+#endif
+
+#define WITH_MARGIN(us) ((uint16_t) (((us) * (100 + LCD_TIMING_MARGIN) + 99) / 100)) ///?> Время с запасом, округлённое вверх
+
+/// Модель времени выполнения: спецификации дают время при fosc = 270 КГц,
+/// время обратно пропорционально частоте генератора (t = t270 * 270 / fosc).
+/// Таблица с запасом проверяется по модели при сборке: время каждого
+/// класса не меньше модельного на частоте LCD_TIMING_FOSC_MIN_KHZ
+#define FOSC_NOM_KHZ    270
+#define MODEL_US(us)    (((us) * FOSC_NOM_KHZ + LCD_TIMING_FOSC_MIN_KHZ - 1) / LCD_TIMING_FOSC_MIN_KHZ) ///?> Время на самой низкой частоте, округлённое вверх
+
+#if (LCD_TIMING_FOSC_MIN_KHZ <= 0) || (LCD_TIMING_FOSC_MIN_KHZ > FOSC_NOM_KHZ)
+#error "LCD_TIMING_FOSC_MIN_KHZ -- от 1 до 270 КГц (номинальной частоты спецификаций)"
+#endif
+
+_Static_assert(WITH_MARGIN(T_CLEAR_US) >= MODEL_US(T_CLEAR_US),
+               "LCD_TIMING_MARGIN не покрывает очистку экрана на частоте LCD_TIMING_FOSC_MIN_KHZ");
+_Static_assert(WITH_MARGIN(T_HOME_US) >= MODEL_US(T_HOME_US),
+               "LCD_TIMING_MARGIN не покрывает возврат курсора на частоте LCD_TIMING_FOSC_MIN_KHZ");
+_Static_assert(WITH_MARGIN(T_CMD_US) >= MODEL_US(T_CMD_US),
+               "LCD_TIMING_MARGIN не покрывает команды на частоте LCD_TIMING_FOSC_MIN_KHZ");
+_Static_assert(WITH_MARGIN(T_DATA_US) >= MODEL_US(T_DATA_US),
+               "LCD_TIMING_MARGIN не покрывает запись данных на частоте LCD_TIMING_FOSC_MIN_KHZ");
+
+/// Номер класса -- номер старшего взведённого бита команды (LCD_InstrClassify)
+_Static_assert(LCD_INSTR_CLEAR == 0 && LCD_INSTR_HOME == 1 && LCD_INSTR_ENTRY_MODE == 2 &&
+               LCD_INSTR_DISPLAY_CONTROL == 3 && LCD_INSTR_SHIFT == 4 && LCD_INSTR_FUNCTION_SET == 5 &&
+               LCD_INSTR_CGRAM_ADDRESS == 6 && LCD_INSTR_DDRAM_ADDRESS == 7,
+               "Классы инструкций не совпадают с номерами бит команд");
+
+/// Таблица времён выполнения с запасом, индекс -- класс инструкции
+static const uint16_t s_instr_time_us[LCD_INSTR_COUNT] = {
+	[LCD_INSTR_CLEAR]           = WITH_MARGIN(T_CLEAR_US),
+	[LCD_INSTR_HOME]            = WITH_MARGIN(T_HOME_US),
+	[LCD_INSTR_ENTRY_MODE]      = WITH_MARGIN(T_CMD_US),
+	[LCD_INSTR_DISPLAY_CONTROL] = WITH_MARGIN(T_CMD_US),
+	[LCD_INSTR_SHIFT]           = WITH_MARGIN(T_CMD_US),
+	[LCD_INSTR_FUNCTION_SET]    = WITH_MARGIN(T_CMD_US),
+	[LCD_INSTR_CGRAM_ADDRESS]   = WITH_MARGIN(T_CMD_US),
+	[LCD_INSTR_DDRAM_ADDRESS]   = WITH_MARGIN(T_CMD_US),
+	[LCD_INSTR_DATA]            = WITH_MARGIN(T_DATA_US),
+};
+
+/** @brief Определяет класс инструкции по коду команды
+ *  @note
+ *  	Класс определяется старшим взведённым битом команды.
+ *  	Нулевой код командой не является и считается самой
+ *  	медленной инструкцией (очистка экрана)
+ *  @param [in] cmd код команды (RS = 0)
+ *  @return класс инструкции
+ */
+LCD_InstrClass LCD_InstrClassify (uint8_t cmd)
+{
+	if (cmd == 0)
+		return LCD_INSTR_CLEAR;
+	return (LCD_InstrClass) (31 - __CLZ(cmd));
+}
+
+/** @brief Время выполнения инструкции с учётом запаса LCD_TIMING_MARGIN
+ *  @param [in] instr класс инструкции
+ *  @return время, мкс
+ */
+uint32_t LCD_InstrTimeUs (LCD_InstrClass instr)
+{
+	return s_instr_time_us[instr];
+}
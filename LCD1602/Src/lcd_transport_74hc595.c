@@ -0,0 +1,624 @@
+/*
+ * lcd_transport_74hc595.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd1602.h"
+#include "lcd_delay.h"
+
+#if (LCD_DATA_TRANSPORT_74HC595 != 0)
+
+/// SRCLK и SER (или SPI2) общие для всех дисплеев на 74HC595,
+/// у каждого дисплея своя защёлка RCLK (LCD_HandleTypeDef::EPort/EPin)
+
+/// Вывод кадров 74HC595 через SPI2 и DMA по событию обновления TIM4
+#define USE_SPI_DMA ((LCD_74HC595_SPI != 0) && (LCD_74HC595_DMA != 0))
+
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+typedef uint16_t reg595_t; ///?> Слово двух каскадных 74HC595: управляющие биты, D4-D7 и D0-D3
+#define REG595_BITS 16     ///?> Разрядность цепочки 74HC595
+#else
+typedef uint8_t  reg595_t; ///?> Байт одного 74HC595: управляющие биты и D4-D7
+#define REG595_BITS 8      ///?> Разрядность цепочки 74HC595
+#endif
+
+static void s_send_8bit      (LCD_HandleTypeDef *hlcd, reg595_t data, uint8_t add); ///?> Отправляет слово 74HC595 вне зависимости от режима отправки со стробами E и add
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+static void s_send_2x4bit    (LCD_HandleTypeDef *hlcd, uint8_t data, uint8_t add); ///?> Разбивает байт на два квартета и отправляет со стробами add
+#endif
+#if (LCD_74HC595_SPI == 0)
+static void s_set_srclk      (void); ///?> Строб 74HC595 SRCLCK (пин 10)
+#endif
+static void s_transport_byte (LCD_HandleTypeDef *hlcd, reg595_t data); ///?> Отправка слова 74HC595, зависящая от транспорта
+
+/// Биты вывода 74HC595
+#define BKL_Bit 0  ///?> Бит включения/выключения освещения подложки
+#define RS_Bit  1  ///?> Бит RS (режим данных)
+#define RW_Bit  2  ///?> Бит RW (записи в память)
+#define E_Bit   3  ///?> Бит E строба данных/команды
+#define D0_Bit  8  ///?> Бит 0 (D0, 8 битный режим)
+#define D1_Bit  9  ///?> Бит 1 (D1, 8 битный режим)
+#define D2_Bit  10 ///?> Бит 2 (D2, 8 битный режим)
+#define D3_Bit  11 ///?> Бит 3 (D3, 8 битный режим)
+#define D4_Bit  4  ///?> Бит 4 (D4, 8/4 битный режим)
+#define D5_Bit  5  ///?> Бит 5 (D5, 8/4 битный режим)
+#define D6_Bit  6  ///?> Бит 6 (D6, 8/4 битный режим)
+#define D7_Bit  7  ///?> Бит 7 (D7, 8/4 битный режим)
+
+/// Временные параметры 74HC595 (спецификация, VCC = 3.3 В, с запасом)
+#define T_595_SU_NS 50 ///?> Установка SER до фронта SRCLK (tsu)
+#define T_595_W_NS  50 ///?> Длительность импульса SRCLK/RCLK (tw)
+
+#if (LCD_74HC595_SPI == 0) && (REG595_BITS * (T_595_SU_NS + T_595_W_NS) < LCD_T_PWEH_NS)
+#error "Программный сдвиг слова 74HC595 короче импульса E (PWEH)"
+#endif
+
+#if (LCD_74HC595_SPI != 0)
+#define SPI_DEVICE SPI2 ///?> SPI2: SCK -- SRCLK, MOSI -- SER
+
+static void s_spi_init (void);
+static uint32_t s_spi_byte_ns = 0; ///?> Время сдвига одного байта (слова) через SPI, нс
+#endif
+
+#if (USE_SPI_DMA != 0) && ((LCD_74HC595_FRAME_SIZE < 6) || (LCD_74HC595_FRAME_SIZE > 65535))
+#error "LCD_74HC595_FRAME_SIZE: от слов строба одной инструкции (6) до 65535 (NDTR DMA)"
+#endif
+
+#if (USE_SPI_DMA != 0)
+#define DMA_STREAM      DMA1_Stream6 ///?> Поток DMA1, канал 2 -- запрос TIM4_UP
+#define DMA_CHANNEL     2
+#define DMA_FLAGS       (DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6)
+#define RCLK_PIN_NUM    12           ///?> Номер пина RCLK (PD12 -- TIM4_CH1)
+
+static void s_dma_init (void);
+static reg595_t s_spi_frame[LCD_74HC595_FRAME_SIZE]; ///?> Кадр: байты (слова) 74HC595, по одному на такт TIM4
+static uint16_t s_spi_len = 0;                       ///?> Число байт в кадре
+static uint32_t s_dma_tick_ns = LCD_74HC595_DMA_TICK_NS; ///?> Фактический такт вывода байт, нс
+static volatile uint8_t s_dma_busy = 0;              ///?> Кадр выводится через DMA
+static LCD_HandleTypeDef *s_dma_owner = NULL;        ///?> Дисплей, чей кадр заполняется или выводится
+
+static void s_frame_begin (LCD_HandleTypeDef *hlcd);
+static void s_frame_end   (LCD_HandleTypeDef *hlcd);
+#endif
+
+/// Битовые маски выводов 74HC595
+#define BKL_MSK (1 << BKL_Bit) ///?> Маска бита включения/выключения освещения подложки
+#define RS_MSK  (1 << RS_Bit)  ///?> Маска бита RS (режим данных)
+#define RW_MSK  (1 << RW_Bit)  ///?> Маска бита RS (режим данных)
+#define EN_MSK  (1 << E_Bit)   ///?> Бит E строба данных/команды
+#define D0_MSK  (1 << D0_Bit)  ///?> Маска бита 0 (D0) 8 битный режим
+#define D1_MSK  (1 << D1_Bit)  ///?> Маска бита 1 (D1) 8 битный режим
+#define D2_MSK  (1 << D2_Bit)  ///?> Маска бита 2 (D2) 8 битный режим
+#define D3_MSK  (1 << D3_Bit)  ///?> Маска бита 3 (D3) 8 битный режим
+#define D4_MSK  (1 << D4_Bit)  ///?> Маска бита 4 (D4) 8/4 битный режим
+#define D5_MSK  (1 << D5_Bit)  ///?> Маска бита 5 (D5) 8/4 битный режим
+#define D6_MSK  (1 << D6_Bit)  ///?> Маска бита 6 (D6) 8/4 битный режим
+#define D7_MSK  (1 << D7_Bit)  ///?> Маска бита 7 (D7) 8/4 битный режим
+
+/// Стробы выбранных контроллеров дисплея. У дисплея 40x4 строб E2
+/// подключается к выходу RW (QC) 74HC595, а RW модуля -- на землю
+/// (транспорт только пишет, BF не читается)
+#define EN_MASK(hlcd) ((((hlcd)->Enable & LCD_ENABLE_E1) ? EN_MSK : 0) | (((hlcd)->Enable & LCD_ENABLE_E2) ? RW_MSK : 0))
+
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+/** @brief Раскладывает байт по выходам двух каскадных 74HC595
+ *  @note
+ *  	D4-D7 лежат на своих местах первого регистра (биты 4-7),
+ *  	D0-D3 -- на младших выходах второго (биты 8-11)
+ *  @param [in] data байт команды/данных
+ *  @return слово для цепочки 74HC595 без управляющих битов
+ */
+static inline reg595_t s_reg_word (uint8_t data)
+{
+	return (reg595_t) ((data & (D4_MSK | D5_MSK | D6_MSK | D7_MSK)) | ((reg595_t) (data & 0x0F) << D0_Bit));
+}
+#endif
+
+/** @brief Инициализация (если нужна) транспортного протокола.
+ *  @note
+ *  	Если защёлка дисплея не задана, берётся RCLK_Pin из main.h.
+ *  	SPI2 и DMA настраиваются при первом вызове
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_transport_init (LCD_HandleTypeDef *hlcd)
+{
+	if (hlcd->EPort == NULL)
+	{
+		hlcd->EPort = RCLK_GPIO_Port;
+		hlcd->EPin  = RCLK_Pin;
+	}
+	hlcd->EPort->BSRR = (uint32_t) hlcd->EPin << 0x10; // Сбросить строб LATCH (12) 74HC595
+#if (LCD_74HC595_SPI != 0)
+	if (s_spi_byte_ns == 0)
+	{
+		s_spi_init();
+#if (USE_SPI_DMA != 0)
+		s_dma_init();
+#endif
+	}
+#else
+	SRCLK_GPIO_Port->BSRR = (SRCLK_Pin << 0x10); // Сбросить строб RSCLK (11) 74HC595
+	SER_GPIO_Port->BSRR = (SER_Pin << 0x10);   // Сбросить строб DATA  (14) 74HC595
+#endif
+}
+
+/** @brief Отправляет байт, как команду (Линия RS не стробируется)
+ *  @note
+ *  	Общая для всех видов траспорта.
+ *  	(Вызывается общей функцией LCD_SendData)
+ *  		RS_Bit -- не стробируется
+ *  		E_Bit  -- стробирует передачу байта/полубайта
+ *  	Для 4-битного режима: старший квартет -- данные, младший -- управляющие биты (E, RS, RW)
+ *  	Прокси/заглушка для выбора между 8/4 бит и отправки команды без стробирования RS
+ *  @param data (uint8_t) данные для отправки
+ *  @return None
+ */
+static void s_send_command (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+#if (USE_SPI_DMA != 0)
+	while (s_dma_busy)
+		; // Дождаться конца вывода кадра
+#endif
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+	s_send_2x4bit(hlcd, data, 0); // Отправить команду, разбив на два квартета в старшем полубайте
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	s_send_8bit(hlcd, s_reg_word(data), 0); // Один цикл защёлки на всю команду
+#endif
+}
+
+/** @brief Отправляет байт, как данные (Линия RS стробируется)
+ *  @note
+ *  	Должна быть определена во всех видах транспорта
+ *  	(Вызывается общей функцией LCD_SendCommand)
+ *  	RS_Bit -- стробируется
+ *  	E_Bit  -- стробирует передачу байта/полубайта
+ *  	В 4-битном режиме старший квартет -- данные, младший -- управляющие биты (E, RS)
+ *  @param data (uint8_t)
+ *  @return None
+ */
+static void s_send_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+#if (USE_SPI_DMA != 0)
+	while (s_dma_busy)
+		; // Дождаться конца вывода кадра
+#endif
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+	s_send_2x4bit(hlcd, data, RS_MSK); // Отправить данные разбив два квартета (в старшем полубайте)
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	s_send_8bit(hlcd, s_reg_word(data), RS_MSK); // Один цикл защёлки на весь символ
+#endif
+}
+
+/** @brief Отправляет 8 бит со стробированием E и add (если != 0)
+ *  @note
+ *  	Отправляет 8 бит вне зависимости от режима передачи 8/4 бита данных
+ *  	Стробит передачу при помощи E_Bit и если add != 0, содержимым add
+ *  	add передавать уже со смещением (маска, MSK).
+ *  	Три защёлки: данные и RS при сброшенном E (tAS), взведённый E,
+ *  	сброшенный E с теми же данными и RS (tH, tAH). Импульс E длится
+ *  	время сдвига следующего слова, через SPI недостающее до PWEH
+ *  	добирается задержкой
+ *  @param
+ *	@return None
+ */
+static void s_send_8bit (LCD_HandleTypeDef *hlcd, reg595_t data, uint8_t add)
+{
+	s_transport_byte(hlcd, data | BKL_MSK | add);
+	s_transport_byte(hlcd, data | BKL_MSK | EN_MASK(hlcd) | add);
+#if (LCD_74HC595_SPI != 0)
+	if (s_spi_byte_ns < LCD_T_PWEH_NS)
+		LCD_DelayNs(LCD_T_PWEH_NS - s_spi_byte_ns);
+#endif
+	s_transport_byte(hlcd, data | BKL_MSK | add);
+}
+
+/** @brief Отправляет байт в 4-битном режиме передачи данных
+ *  @note
+ *  	В режиме данных 4 бита разбивает данные на 2 байта
+ *  		в которых:
+ *  			1. старший квартет -- данные,
+ *  			2. младший квартет -- управляющие биты (LCD1602)
+ *  	add может содержать
+ *  		E_Bit  -- Строб передачи данных
+ *  		RS_Bit -- Строб передачи команды
+ *  		RW_Bit -- Строб записи в память (например, символа)
+ *  	D0, D1, D2, D3, D4, D5, D6, D7 -- для 8битной передачи
+ *  	D4, D5, D6, D7                 -- для 4битной передачи
+ *  @return None
+ */
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+static void s_send_2x4bit (LCD_HandleTypeDef *hlcd, uint8_t data, uint8_t add)
+{
+	// Отправить содержимое старшего квартета данных
+	// и установить добавочные данные в младший полубит
+    s_send_8bit(hlcd, (data) & 0xF0, add);
+    // Отправить содержимое младшего квартета данных в старшем квартете
+    // и установить добавочные данные в младший полубит
+    s_send_8bit(hlcd, (data << 4) & 0xF0, add);
+}
+#endif
+
+/** @brief Время передачи байта дисплею через 74HC595
+ *  @note
+ *  	Цикл E -- три слова (s_send_8bit): через SPI с добором импульса
+ *  	E до PWEH, программно -- по REG595_BITS тактов SRCLK.
+ *  	В 4-битном режиме циклов E два
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return время, нс
+ */
+static uint32_t s_byte_time_ns (LCD_HandleTypeDef *hlcd)
+{
+	(void) hlcd;
+#if (LCD_74HC595_SPI != 0)
+	uint32_t cycle = 3U * s_spi_byte_ns + ((s_spi_byte_ns < LCD_T_PWEH_NS) ? LCD_T_PWEH_NS - s_spi_byte_ns : 0);
+#else
+	uint32_t cycle = 3U * (REG595_BITS * (T_595_SU_NS + T_595_W_NS) + T_595_W_NS);
+#endif
+	return (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE) ? 2U * cycle : cycle;
+}
+
+#if (LCD_74HC595_SPI == 0)
+/** @brief Устанавливает сигнал на пине 74HC595 SRCLK (11)
+ *  @note
+ *		Функция реализована для транспорта 74HC595
+ *	@return None
+ */
+static void s_set_srclk(void)
+{
+	LCD_DelayNs(T_595_SU_NS); // Установка SER до фронта
+	SRCLK_GPIO_Port->BSRR = (SRCLK_Pin); // Установить пин SRCLK
+	LCD_DelayNs(T_595_W_NS);  // Длительность импульса
+	SRCLK_GPIO_Port->BSRR = (SRCLK_Pin << 0x10); // Сбросить пин SRCLK
+}
+
+/** @brief отправка байта/полубайта через выбранный транспорт
+ *  @note
+ *  	Должна быть реализована во всех реализация транспорта
+ *  	Транспорты:
+ *  		1. Пины 4/8-бит + Управляющие пины
+ *  		2. 74HC595 данные 4-бит
+ *  		3. PCF8574T данные 4-бит
+ *  	Режим работы:
+ *  		1. Запуск клок-сигнала для передачи битов (c 1)
+ *  		2. Передача по дата-каналу 0/1
+ *  		3. После завершения байта взвести защёлку (LATCH)
+ *  	Пины подключены в последовательности
+ *  		QD -> D4
+ *  		QE -> D5
+ *  		QF -> D6
+ *  		QH -> D7
+ *  	В 8-битном режиме второй 74HC595 включён каскадом (QH' -> SER),
+ *  	его выходы QA-QD -- D0-D3, слово сдвигается целиком (16 бит)
+ *  	Отправка идёт со старшего по 0 бит.
+ *  	Защёлкивается регистр дисплея hlcd
+ */
+static void s_transport_byte (LCD_HandleTypeDef *hlcd, reg595_t data)
+{
+	hlcd->EPort->BSRR = (uint32_t) hlcd->EPin << 0x10;
+	uint8_t cnt = REG595_BITS; // Счётчик бит
+	s_set_srclk ();
+	while(cnt --) // Счёт от 7 до 0
+	{
+		SER_GPIO_Port->BSRR  = ((data >> cnt) & 1) ? (SER_Pin) : (SER_Pin << 0x10);
+		s_set_srclk ();
+	}
+	hlcd->EPort->BSRR = hlcd->EPin; // Установить защёлку и открыть установленные данные на передачу на пинах QA-QH 74HC595
+	SER_GPIO_Port->BSRR  = (SER_Pin << 0x10); // Сбросить пин данных в 0
+	LCD_DelayNs(T_595_W_NS); // Длительность импульса защёлки
+}
+#else
+/** @brief Отправка байта в 74HC595 через SPI2 и защёлка RCLK
+ *  @note
+ *  	SPI2 сдвигает байт старшим битом вперёд (как и программная
+ *  	реализация), после окончания сдвига (BSY == 0) импульс RCLK
+ *  	открывает данные на выходах QA-QH.
+ *  	В 8-битном режиме SPI работает 16-битными кадрами (DFF)
+ *  	и за одну защёлку обновляет оба каскадных регистра
+ *  @param [in] hlcd дескриптор дисплея (защёлка RCLK)
+ *  @param [in] data байт/слово для 74HC595
+ *  @return None
+ */
+static void s_transport_byte (LCD_HandleTypeDef *hlcd, reg595_t data)
+{
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	SPI_DEVICE->DR = data;
+#else
+	*(volatile uint8_t *) &SPI_DEVICE->DR = data;
+#endif
+	while (!(SPI_DEVICE->SR & SPI_SR_TXE))
+		;
+	while (SPI_DEVICE->SR & SPI_SR_BSY)
+		;
+	hlcd->EPort->BSRR = hlcd->EPin;
+	LCD_DelayNs(T_595_W_NS); // Длительность импульса защёлки
+	hlcd->EPort->BSRR = (uint32_t) hlcd->EPin << 0x10;
+}
+
+/** @brief Настройка SPI2 для 74HC595
+ *  @note
+ *  	SRCLK -- PB13 (SPI2_SCK), SER -- PB15 (SPI2_MOSI), RCLK -- свой у каждого дисплея.
+ *  	Режим 0 (74HC595 сдвигает по фронту SRCLK), ведущий,
+ *  	программный NSS, только передача. Запоминает время сдвига байта
+ *  @return None
+ */
+static void s_spi_init (void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_SPI2_CLK_ENABLE();
+
+	GPIO_InitStruct.Pin = GPIO_PIN_13 | GPIO_PIN_15;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF5_SPI2;
+	HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+	SPI_DEVICE->CR1 = 0;
+	SPI_DEVICE->CR2 = 0;
+	SPI_DEVICE->CR1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI |
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	                  SPI_CR1_DFF |                        // 16 бит: два каскадных 74HC595
+#endif
+	                  ((LCD_74HC595_SPI_BR & 0x07U) << SPI_CR1_BR_Pos);
+	SPI_DEVICE->CR1 |= SPI_CR1_SPE;
+
+	uint32_t spi_khz = (HAL_RCC_GetPCLK1Freq() >> (LCD_74HC595_SPI_BR + 1)) / 1000U;
+	s_spi_byte_ns = (REG595_BITS * 1000000U + spi_khz - 1) / spi_khz;
+}
+#endif
+
+#if (USE_SPI_DMA != 0)
+/** @brief Настройка TIM4 и DMA1 Stream6 для вывода кадра в SPI2
+ *  @note
+ *  	Событие обновления TIM4 (период LCD_74HC595_DMA_TICK_NS)
+ *  	запрашивает у DMA перенос байта кадра в SPI2->DR. Канал 1
+ *  	TIM4 в режиме ШИМ 2 выдаёт на PD12 (RCLK) фронт защёлки
+ *  	после окончания сдвига байта, так что каждый байт кадра
+ *  	защёлкивается без участия процессора. Поэтому кадры через
+ *  	DMA выводятся только дисплею с защёлкой RCLK_Pin (PD12)
+ *  @return None
+ */
+static void s_dma_init (void)
+{
+	uint32_t clock = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+		clock *= 2; // Таймеры APB1 тактируются удвоенной частотой шины
+	uint32_t mhz = clock / 1000000U;
+
+	__HAL_RCC_TIM4_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	// PD12 -- TIM4_CH1 (AF2). Пин переключается в альтернативный режим только на время кадра
+	RCLK_GPIO_Port->AFR[RCLK_PIN_NUM >> 3] = (RCLK_GPIO_Port->AFR[RCLK_PIN_NUM >> 3] & ~(0x0FUL << ((RCLK_PIN_NUM & 7) * 4))) |
+	                                         (GPIO_AF2_TIM4 << ((RCLK_PIN_NUM & 7) * 4));
+
+	// Фронт RCLK -- после сдвига байта (с запасом на задержку DMA), импульс не короче tw
+	uint32_t latch = mhz * (s_spi_byte_ns + 100U) / 1000U;
+	uint32_t period = mhz * LCD_74HC595_DMA_TICK_NS / 1000U;
+	if (period < latch + mhz * T_595_W_NS / 1000U + 1)
+		period = latch + mhz * T_595_W_NS / 1000U + 1;
+	s_dma_tick_ns = period * 1000U / mhz;
+
+	TIM4->CR1   = 0;
+	TIM4->PSC   = 0;
+	TIM4->ARR   = period - 1;
+	TIM4->CCR1  = latch;
+	TIM4->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_0; // ШИМ 2: RCLK = 1 при CNT >= CCR1
+	TIM4->CCER  = TIM_CCER_CC1E;
+	TIM4->DIER  = TIM_DIER_UDE;           // Запрос DMA по обновлению
+
+	DMA_STREAM->CR  = 0;
+	DMA_STREAM->PAR = (uint32_t) &SPI_DEVICE->DR;
+	DMA_STREAM->CR  = (DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) |
+	                  DMA_SxCR_PL_1 |                      // Высокий приоритет
+#if (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	                  DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | // Полуслова 16 бит
+#endif
+	                  DMA_SxCR_MINC |                      // Инкремент по памяти
+	                  DMA_SxCR_DIR_0 |                     // Память -> периферия
+	                  DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+	HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, LCD_74HC595_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+}
+
+/** @brief Переключает PD12 (RCLK) между GPIO и выходом TIM4_CH1
+ *  @param [in] af 1 -- TIM4_CH1, 0 -- выход GPIO
+ *  @return None
+ */
+static inline void s_rclk_af (uint8_t af)
+{
+	uint32_t moder = RCLK_GPIO_Port->MODER & ~(0x03UL << (RCLK_PIN_NUM * 2));
+	RCLK_GPIO_Port->MODER = moder | ((af ? 0x02UL : 0x01UL) << (RCLK_PIN_NUM * 2));
+}
+
+/** @brief Запуск вывода накопленного кадра
+ *  @return None
+ */
+static void s_dma_start (void)
+{
+	s_dma_busy = 1;
+	s_rclk_af(1);
+	DMA1->HIFCR       = DMA_FLAGS;
+	DMA_STREAM->M0AR  = (uint32_t) s_spi_frame;
+	DMA_STREAM->NDTR  = s_spi_len;
+	DMA_STREAM->CR   |= DMA_SxCR_EN;
+	TIM4->CNT  = 0;
+	TIM4->CR1 |= TIM_CR1_CEN;
+}
+
+/** @brief Добавляет в кадр инструкцию и паузу на её выполнение
+ *  @note
+ *  	Каждый квартет (в 8-битном режиме -- весь байт) -- три слова
+ *  	(данные, E, сброс E), затем повторы последнего слова на время
+ *  	выполнения инструкции.
+ *  	Если инструкция не помещается, текущий кадр выводится
+ *  	и кадр начинается заново (с ожиданием конца вывода).
+ *  	Пауза длиннее пустого кадра (очистка при коротком такте)
+ *  	продолжается повторами в следующем кадре
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт команды/данных
+ *  @param [in] add  RS_MSK для данных, 0 для команды
+ *  @param [in] us   время выполнения инструкции, мкс
+ *  @return None
+ */
+static void s_frame_op (LCD_HandleTypeDef *hlcd, uint8_t data, uint8_t add, uint32_t us)
+{
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+	const uint32_t strobe = 6;
+#else
+	const uint32_t strobe = 3;
+#endif
+	uint32_t idle = (us * 1000U + s_dma_tick_ns - 1) / s_dma_tick_ns;
+	if (s_spi_len + strobe + idle > LCD_74HC595_FRAME_SIZE)
+	{
+		s_frame_end(hlcd);
+		s_frame_begin(hlcd);
+	}
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+	reg595_t hi = (data & 0xF0) | BKL_MSK | add;
+	reg595_t lo = ((data << 4) & 0xF0) | BKL_MSK | add;
+	s_spi_frame[s_spi_len ++] = hi;
+	s_spi_frame[s_spi_len ++] = hi | EN_MASK(hlcd);
+	s_spi_frame[s_spi_len ++] = hi;
+#else
+	reg595_t lo = s_reg_word(data) | BKL_MSK | add;
+#endif
+	s_spi_frame[s_spi_len ++] = lo;
+	s_spi_frame[s_spi_len ++] = lo | EN_MASK(hlcd);
+	s_spi_frame[s_spi_len ++] = lo;
+	while (idle --)
+	{
+		if (s_spi_len >= LCD_74HC595_FRAME_SIZE)
+		{
+			s_frame_end(hlcd);
+			s_frame_begin(hlcd);
+		}
+		s_spi_frame[s_spi_len ++] = lo;
+	}
+}
+
+/** @brief Проверка, что дисплей выводит кадры через DMA
+ *  @note
+ *  	Фронт защёлки в кадре DMA формирует TIM4_CH1 на PD12, поэтому
+ *  	дисплей с другой защёлкой получает инструкции кадра сразу
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- защёлка дисплея RCLK_Pin (TIM4_CH1)
+ */
+static inline uint8_t s_dma_latch (LCD_HandleTypeDef *hlcd)
+{
+	return (hlcd->EPort == RCLK_GPIO_Port) && (hlcd->EPin == RCLK_Pin);
+}
+
+/** @brief Начало кадра
+ *  @note
+ *  	Буфер кадра один на все дисплеи, поэтому ждёт окончания
+ *  	вывода предыдущего. Кадры разных дисплеев не перемежаются
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_begin (LCD_HandleTypeDef *hlcd)
+{
+	if (!s_dma_latch(hlcd))
+		return;
+	while (s_dma_busy)
+		;
+	s_dma_owner = hlcd;
+	s_spi_len = 0;
+}
+
+/** @brief Добавляет в кадр команду
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] cmd  код команды
+ *  @return None
+ */
+static void s_frame_command (LCD_HandleTypeDef *hlcd, uint8_t cmd)
+{
+	if (s_dma_latch(hlcd))
+		s_frame_op(hlcd, cmd, 0, LCD_InstrTimeUs(LCD_InstrClassify(cmd)));
+	else
+		LCD_SendCommand(hlcd, cmd);
+}
+
+/** @brief Добавляет в кадр байт данных
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт данных
+ *  @return None
+ */
+static void s_frame_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+	if (s_dma_latch(hlcd))
+		s_frame_op(hlcd, data, RS_MSK, LCD_InstrTimeUs(LCD_INSTR_DATA));
+	else
+		LCD_SendData(hlcd, data);
+}
+
+/** @brief Запускает вывод кадра через DMA и сразу возвращается
+ *  @note
+ *  	По окончании вызывается LCD_FrameCompleteCallback (из прерывания)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_end (LCD_HandleTypeDef *hlcd)
+{
+	if (!s_dma_latch(hlcd) || s_spi_len == 0)
+	{
+		LCD_FrameCompleteCallback(hlcd);
+		return;
+	}
+	s_dma_start();
+}
+
+/** @brief Проверка, что кадр дисплея ещё выводится
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- DMA выводит кадр этого дисплея, 0 -- свободен
+ */
+static uint8_t s_frame_busy (LCD_HandleTypeDef *hlcd)
+{
+	return s_dma_busy && (s_dma_owner == hlcd);
+}
+
+/** @brief Обработчик прерывания DMA1 Stream6: конец вывода кадра
+ *  @note
+ *  	Вызывается из DMA1_Stream6_IRQHandler (stm32f4xx_it.c).
+ *  	Последний байт кадра -- повтор паузы, поэтому все стробы
+ *  	уже защёлкнуты. RCLK возвращается в GPIO
+ *  @return None
+ */
+void LCD_SpiDmaIRQHandler (void)
+{
+	uint32_t flags = DMA1->HISR;
+	DMA1->HIFCR = DMA_FLAGS;
+	if (flags & (DMA_HISR_TCIF6 | DMA_HISR_TEIF6))
+	{
+		TIM4->CR1 &= ~TIM_CR1_CEN;
+		DMA_STREAM->CR &= ~DMA_SxCR_EN;
+		RCLK_GPIO_Port->BSRR = (RCLK_Pin << 0x10);
+		s_rclk_af(0);
+		s_dma_busy = 0;
+		LCD_FrameCompleteCallback(s_dma_owner);
+	}
+}
+#endif
+
+/// Операции транспорта 74HC595
+const LCD_TransportTypeDef LCD_Transport74HC595 = {
+	.Width        = LCD_DATA_WIDTH,
+	.Init         = s_transport_init,
+	.SendCommand  = s_send_command,
+	.SendData     = s_send_data,
+#if (USE_SPI_DMA != 0)
+	.FrameBegin   = s_frame_begin,
+	.FrameCommand = s_frame_command,
+	.FrameData    = s_frame_data,
+	.FrameEnd     = s_frame_end,
+	.FrameBusy    = s_frame_busy,
+#endif
+	.ByteTimeNs   = s_byte_time_ns,
+};
+#endif
+
@@ -0,0 +1,378 @@
+/*
+ * lcd_transport_fsmc.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd1602.h"
+
+#if (LCD_DATA_TRANSPORT_FSMC != 0)
+
+/// Подключение (режим 8080, запись):
+///   D0-D7 -- FSMC_D0-D7 (PD14, PD15, PD0, PD1, PE7, PE8, PE9, PE10)
+///   RS    -- FSMC_A16 (PD11)
+///   E     -- NOR(NEx, FSMC_NWE (PD5)), RW -- на землю
+/// У каждого дисплея свой банк NE1-NE4 (LCD_HandleTypeDef::Address 0-3):
+/// NE1 -- PD7, NE2 -- PG9, NE3 -- PG10, NE4 -- PG12. С одним дисплеем
+/// на NE1 вместо NOR достаточно инвертора NWE
+#define FSMC_BANK_ADDR   0x60000000UL ///?> FSMC Bank1, NE1
+#define FSMC_BANK_SIZE   0x04000000UL ///?> Размер области одного NEx
+#define FSMC_BANKS       4            ///?> Число областей NE1-NE4
+#define FSMC_RS_ADDR     (1UL << 16)  ///?> RS -- линия A16 (при 8-битной шине адрес байтовый)
+#define FSMC_COMMAND(base) (*(volatile uint8_t *) (base))                  ///?> Запись команды (RS = 0)
+#define FSMC_DATA(base)    (*(volatile uint8_t *) ((base) | FSMC_RS_ADDR)) ///?> Запись данных (RS = 1)
+#define FSMC_BASE(hlcd)    ((uint32_t) (hlcd)->Context)                    ///?> Адрес банка дисплея
+
+#if (LCD_FSMC_DMA != 0)
+#define DMA_STREAM      DMA2_Stream5 ///?> Поток DMA2, канал 6 -- запрос TIM1_UP
+#define DMA_CHANNEL     6
+#define DMA_FLAGS       (DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5)
+#define FSMC_NO_COMMAND 0xFFFF       ///?> Отрезок кадра без команды
+
+/// Отрезок кадра: команда (через CPU) и следующая за ней строка данных (через DMA)
+typedef struct {
+	uint16_t cmd;   ///?> Команда или FSMC_NO_COMMAND
+	uint16_t start; ///?> Начало данных в s_fsmc_frame
+	uint16_t len;   ///?> Число байт данных
+} fsmc_seg_t;
+
+static uint8_t    s_fsmc_frame[LCD_FSMC_FRAME_SIZE];   ///?> Данные кадра
+static fsmc_seg_t s_fsmc_seg[LCD_FSMC_FRAME_SEGMENTS]; ///?> Отрезки кадра
+static uint16_t   s_fsmc_len = 0;                      ///?> Число байт данных в кадре
+static uint8_t    s_fsmc_segs = 0;                     ///?> Число отрезков в кадре
+static uint8_t    s_fsmc_pos = 0;                      ///?> Номер следующего выводимого отрезка
+static uint16_t   s_fsmc_data_us = 0;                  ///?> Такт вывода данных (время выполнения записи), мкс
+static volatile uint8_t s_dma_busy = 0;                ///?> Кадр выводится
+static LCD_HandleTypeDef *s_dma_owner = NULL;          ///?> Дисплей, чей кадр заполняется или выводится
+
+static void s_dma_init (void);
+static void s_frame_begin (LCD_HandleTypeDef *hlcd);
+static void s_frame_end   (LCD_HandleTypeDef *hlcd);
+#endif
+
+/** @brief Настройка банка FSMC Bank1 дисплея как 8-битной SRAM
+ *  @note
+ *  	ADDSET -- установка адреса (RS) до NWE (tAS),
+ *  	DATAST -- длительность NWE, то есть импульса E (PWEH),
+ *  	BUSTURN -- пауза между обращениями.
+ *  	Запись фиксируется по фронту NWE (спад E). Ожидание
+ *  	выполнения инструкции -- по таблице времён, флаг
+ *  	занятости не читается (RW на земле).
+ *  	Шина данных, A16 и NWE общие, настраиваются каждый раз;
+ *  	пин NEx и регистры -- своего банка.
+ *  	Дисплеи с двумя контроллерами (40x4) не поддерживаются
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_transport_init (LCD_HandleTypeDef *hlcd)
+{
+	static GPIO_TypeDef *const ne_port[FSMC_BANKS] = { GPIOD, GPIOG, GPIOG, GPIOG };
+	static const uint16_t      ne_pin[FSMC_BANKS]  = { GPIO_PIN_7, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_12 };
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	uint32_t bank = hlcd->Address;
+
+	if (bank >= FSMC_BANKS || hlcd->Geometry->E2Row)
+	{
+		Error_Handler(); // Строб E -- один NEx банка, второго контроллера нет
+	}
+	hlcd->Context = (void *) (FSMC_BANK_ADDR + bank * FSMC_BANK_SIZE);
+
+	__HAL_RCC_GPIOD_CLK_ENABLE();
+	__HAL_RCC_GPIOE_CLK_ENABLE();
+	__HAL_RCC_GPIOG_CLK_ENABLE();
+	__HAL_RCC_FSMC_CLK_ENABLE();
+
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF12_FSMC;
+	GPIO_InitStruct.Pin = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_5 | GPIO_PIN_11 | GPIO_PIN_14 | GPIO_PIN_15;
+	HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
+	GPIO_InitStruct.Pin = GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9 | GPIO_PIN_10;
+	HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
+	GPIO_InitStruct.Pin = ne_pin[bank];
+	HAL_GPIO_Init(ne_port[bank], &GPIO_InitStruct);
+
+	uint32_t mhz = HAL_RCC_GetHCLKFreq() / 1000000U;
+	uint32_t addset = (LCD_T_AS_NS * mhz + 999U) / 1000U;
+	uint32_t datast = (LCD_T_PWEH_NS * mhz + 999U) / 1000U;
+	if (addset > 15)
+		addset = 15;
+	if (datast > 255)
+		datast = 255;
+
+	FSMC_Bank1->BTCR[bank * 2 + 1] = (addset << FSMC_BTR1_ADDSET_Pos) |
+	                                 (datast << FSMC_BTR1_DATAST_Pos) |
+	                                 FSMC_BTR1_BUSTURN_Msk;            // Максимальная пауза между обращениями
+	FSMC_Bank1->BTCR[bank * 2]     = FSMC_BCR1_WREN | FSMC_BCR1_MBKEN;  // SRAM, 8 бит, без мультиплексирования
+#if (LCD_FSMC_DMA != 0)
+	s_dma_init();
+#endif
+}
+
+/** @brief Отправляет байт, как команду
+ *  @note
+ *  	Одна запись по адресу банка с A16 = 0, строб E формирует FSMC
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param data (uint8_t) команда
+ *  @return None
+ */
+static void s_send_command (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+#if (LCD_FSMC_DMA != 0)
+	while (s_dma_busy)
+		; // Дождаться конца вывода кадра
+#endif
+	FSMC_COMMAND(FSMC_BASE(hlcd)) = data;
+	__DSB(); // Запись в FSMC буферизуется, дождаться её окончания до отсчёта времени выполнения
+}
+
+/** @brief Отправляет байт, как данные
+ *  @note
+ *  	Одна запись по адресу банка с A16 = 1 (RS)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param data (uint8_t) данные
+ *  @return None
+ */
+static void s_send_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+#if (LCD_FSMC_DMA != 0)
+	while (s_dma_busy)
+		; // Дождаться конца вывода кадра
+#endif
+	FSMC_DATA(FSMC_BASE(hlcd)) = data;
+	__DSB();
+}
+
+#if (LCD_FSMC_DMA != 0)
+/** @brief Настройка TIM1 и DMA2 Stream5 для вывода строк данных кадра
+ *  @note
+ *  	TIM1 считает микросекунды. Событие обновления запрашивает
+ *  	у DMA запись очередного байта по адресу данных FSMC.
+ *  	Копирование память-память без такта не подходит:
+ *  	запись каждого байта выполняется контроллером десятки мкс.
+ *  	Адрес данных FSMC задаётся при запуске кадра (банк владельца)
+ *  @return None
+ */
+static void s_dma_init (void)
+{
+	static uint8_t ready = 0;
+	if (ready)
+		return;
+	ready = 1;
+
+	uint32_t clock = HAL_RCC_GetPCLK2Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1)
+		clock *= 2; // Таймеры APB2 тактируются удвоенной частотой шины
+
+	__HAL_RCC_TIM1_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+
+	s_fsmc_data_us = LCD_InstrTimeUs(LCD_INSTR_DATA);
+
+	TIM1->CR1  = TIM_CR1_ARPE | TIM_CR1_URS; // ARR через буфер, обновление только по переполнению
+	TIM1->PSC  = clock / 1000000U - 1;       // 1 МГц
+	TIM1->DIER = 0;
+
+	DMA_STREAM->CR  = 0;
+	DMA_STREAM->CR  = (DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) |
+	                  DMA_SxCR_PL_1 |                      // Высокий приоритет
+	                  DMA_SxCR_MINC |                      // Инкремент по памяти, байты
+	                  DMA_SxCR_DIR_0 |                     // Память -> FSMC
+	                  DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+	HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, LCD_FSMC_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+	HAL_NVIC_SetPriority(TIM1_UP_TIM10_IRQn, LCD_FSMC_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(TIM1_UP_TIM10_IRQn);
+}
+
+/** @brief Запуск TIM1: первое событие через first мкс, далее через next мкс
+ *  @param [in] first первый период, мкс
+ *  @param [in] next  последующие периоды, мкс
+ *  @param [in] dier  TIM_DIER_UDE (строка данных) или TIM_DIER_UIE (пауза)
+ *  @return None
+ */
+static void s_tim_start (uint32_t first, uint32_t next, uint32_t dier)
+{
+	TIM1->CR1 &= ~TIM_CR1_CEN;
+	TIM1->DIER = 0;
+	TIM1->ARR  = first - 1;
+	TIM1->EGR  = TIM_EGR_UG; // Загрузить первый период, CNT = 0
+	TIM1->SR   = 0;
+	TIM1->ARR  = next - 1;   // Вступит в силу после первого события
+	TIM1->DIER = dier;
+	TIM1->CR1 |= TIM_CR1_CEN;
+}
+
+/** @brief Выводит следующий отрезок кадра или завершает кадр
+ *  @note
+ *  	Команда записывается процессором, затем по TIM1 через её
+ *  	время выполнения DMA начинает строку данных. Отрезок без
+ *  	данных -- только пауза на выполнение команды (прерывание TIM1)
+ *  @return None
+ */
+static void s_seg_next (void)
+{
+	if (s_fsmc_pos >= s_fsmc_segs)
+	{
+		TIM1->CR1 &= ~TIM_CR1_CEN;
+		TIM1->DIER = 0;
+		s_dma_busy = 0;
+		LCD_FrameCompleteCallback(s_dma_owner);
+		return;
+	}
+	fsmc_seg_t *seg = &s_fsmc_seg[s_fsmc_pos ++];
+	uint32_t wait = s_fsmc_data_us;
+	if (seg->cmd != FSMC_NO_COMMAND)
+	{
+		FSMC_COMMAND(FSMC_BASE(s_dma_owner)) = (uint8_t) seg->cmd;
+		wait = LCD_InstrTimeUs(LCD_InstrClassify((uint8_t) seg->cmd));
+	}
+	if (seg->len)
+	{
+		DMA2->HIFCR       = DMA_FLAGS;
+		DMA_STREAM->M0AR  = (uint32_t) &s_fsmc_frame[seg->start];
+		DMA_STREAM->NDTR  = seg->len;
+		DMA_STREAM->CR   |= DMA_SxCR_EN;
+		s_tim_start(wait, s_fsmc_data_us, TIM_DIER_UDE);
+	}
+	else
+	{
+		s_tim_start(wait, wait, TIM_DIER_UIE);
+	}
+}
+
+/** @brief Начало кадра
+ *  @note
+ *  	Буфер кадра один на все дисплеи, поэтому ждёт окончания
+ *  	вывода предыдущего. Кадры разных дисплеев не перемежаются
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_begin (LCD_HandleTypeDef *hlcd)
+{
+	while (s_dma_busy)
+		;
+	s_dma_owner = hlcd;
+	s_fsmc_len  = 0;
+	s_fsmc_segs = 0;
+}
+
+/** @brief Добавляет в кадр команду (начинает новый отрезок)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] cmd  код команды
+ *  @return None
+ */
+static void s_frame_command (LCD_HandleTypeDef *hlcd, uint8_t cmd)
+{
+	if (s_fsmc_segs >= LCD_FSMC_FRAME_SEGMENTS)
+	{
+		s_frame_end(hlcd);
+		s_frame_begin(hlcd);
+	}
+	fsmc_seg_t *seg = &s_fsmc_seg[s_fsmc_segs ++];
+	seg->cmd   = cmd;
+	seg->start = s_fsmc_len;
+	seg->len   = 0;
+}
+
+/** @brief Добавляет в кадр байт данных (в строку текущего отрезка)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт данных
+ *  @return None
+ */
+static void s_frame_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+	if (s_fsmc_len >= LCD_FSMC_FRAME_SIZE)
+	{
+		s_frame_end(hlcd);
+		s_frame_begin(hlcd);
+	}
+	if (s_fsmc_segs == 0)
+	{
+		s_fsmc_seg[0].cmd   = FSMC_NO_COMMAND;
+		s_fsmc_seg[0].start = s_fsmc_len;
+		s_fsmc_seg[0].len   = 0;
+		s_fsmc_segs = 1;
+	}
+	s_fsmc_frame[s_fsmc_len ++] = data;
+	s_fsmc_seg[s_fsmc_segs - 1].len ++;
+}
+
+/** @brief Запускает вывод кадра и сразу возвращается
+ *  @note
+ *  	По окончании вызывается LCD_FrameCompleteCallback (из прерывания)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_end (LCD_HandleTypeDef *hlcd)
+{
+	if (s_fsmc_segs == 0)
+	{
+		LCD_FrameCompleteCallback(hlcd);
+		return;
+	}
+	DMA_STREAM->PAR = (uint32_t) &FSMC_DATA(FSMC_BASE(hlcd));
+	s_dma_busy = 1;
+	s_fsmc_pos = 0;
+	s_seg_next();
+}
+
+/** @brief Проверка, что кадр дисплея ещё выводится
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- кадр этого дисплея выводится, 0 -- свободен
+ */
+static uint8_t s_frame_busy (LCD_HandleTypeDef *hlcd)
+{
+	return s_dma_busy && (s_dma_owner == hlcd);
+}
+
+/** @brief Обработчик прерывания DMA2 Stream5: строка данных записана
+ *  @note
+ *  	Вызывается из DMA2_Stream5_IRQHandler (stm32f4xx_it.c).
+ *  	Последний байт строки ещё выполняется, поэтому следующий
+ *  	отрезок начинается по TIM1 через такт данных
+ *  @return None
+ */
+void LCD_FsmcDmaIRQHandler (void)
+{
+	uint32_t flags = DMA2->HISR;
+	DMA2->HIFCR = DMA_FLAGS;
+	if (flags & (DMA_HISR_TCIF5 | DMA_HISR_TEIF5))
+	{
+		DMA_STREAM->CR &= ~DMA_SxCR_EN;
+		s_tim_start(s_fsmc_data_us, s_fsmc_data_us, TIM_DIER_UIE);
+	}
+}
+
+/** @brief Обработчик прерывания TIM1: пауза на выполнение истекла
+ *  @note
+ *  	Вызывается из TIM1_UP_TIM10_IRQHandler (stm32f4xx_it.c)
+ *  @return None
+ */
+void LCD_FsmcTimIRQHandler (void)
+{
+	if (TIM1->SR & TIM_SR_UIF)
+	{
+		TIM1->SR = ~TIM_SR_UIF;
+		s_seg_next();
+	}
+}
+#endif
+
+/// Операции транспорта FSMC
+const LCD_TransportTypeDef LCD_TransportFSMC = {
+	.Width        = LCD_DATA_WIDTH_BYTE,
+	.Init         = s_transport_init,
+	.SendCommand  = s_send_command,
+	.SendData     = s_send_data,
+#if (LCD_FSMC_DMA != 0)
+	.FrameBegin   = s_frame_begin,
+	.FrameCommand = s_frame_command,
+	.FrameData    = s_frame_data,
+	.FrameEnd     = s_frame_end,
+	.FrameBusy    = s_frame_busy,
+#endif
+};
+#endif
@@ -0,0 +1,632 @@
+/*
+ * lcd_transport_gpio.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd1602.h"
+#include "lcd_delay.h"
+
+#if (LCD_DATA_TRANSPORT_GPIO != 0) ///?> Блок управления при помощи GPIO. Для полубайта и байта
+
+/// Шина данных и RS/RW общие для всех дисплеев на GPIO, у каждого
+/// дисплея свой строб E (LCD_HandleTypeDef::EPort/EPin)
+
+/// Флаг занятости опрашивается только в синхронном режиме
+#define USE_BUSY_FLAG ((LCD_GPIO_BUSY_FLAG != 0) && (LCD_ASYNC_MODE == 0))
+
+/// Вывод кадров через DMA в BSRR по событию обновления TIM1
+#define USE_GPIO_DMA  (LCD_GPIO_DMA != 0)
+
+#if (USE_GPIO_DMA != 0) && ((LCD_GPIO_DMA_FRAME_WORDS < 6) || (LCD_GPIO_DMA_FRAME_WORDS > 65535))
+#error "LCD_GPIO_DMA_FRAME_WORDS: от слов строба одной инструкции (6) до 65535 (NDTR DMA)"
+#endif
+
+
+/// Пины раскладываются по портам на этапе компиляции: для каждого порта из
+/// LCD_GPIO_PORTS собираются маски пинов, и запись в порт без пинов дисплея
+/// выбрасывается компилятором. Если все пины на одном порту, фаза -- одна запись BSRR
+#define PIN_IN(pin_port, pin, port) (((uint32_t) (pin_port) == (uint32_t) (port)) ? (uint32_t) (pin) : 0U) ///?> Маска пина, если он на порту port, иначе 0
+#define PORT_PIN(name, port) PIN_IN(name##_GPIO_Port, name##_Pin, port) ///?> Маска пина name (D0-D7, RS, RW, E) на порту port
+
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+#define PORT_DATA_PINS(port) (PORT_PIN(D4, port) | PORT_PIN(D5, port) | PORT_PIN(D6, port) | PORT_PIN(D7, port))
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+#define PORT_DATA_PINS(port) (PORT_PIN(D0, port) | PORT_PIN(D1, port) | PORT_PIN(D2, port) | PORT_PIN(D3, port) | \
+                              PORT_PIN(D4, port) | PORT_PIN(D5, port) | PORT_PIN(D6, port) | PORT_PIN(D7, port))
+#endif
+#define PORT_CTRL_PINS(port) (PORT_PIN(RS, port) | PORT_PIN(RW, port) | PORT_PIN(E, port)) ///?> Управляющие пины на порту port
+
+/// Вывод кадров через DMA пишет в BSRR одного порта -- порта шины данных
+#define GPIO_PORT D4_GPIO_Port
+
+static inline uint32_t s_gpio_word (uint8_t data);
+static void s_set_gpio       (uint8_t data, uint8_t rs);
+static void s_transport_byte (LCD_HandleTypeDef *hlcd, uint8_t data, uint8_t rs);
+static inline void s_strobe  (LCD_HandleTypeDef *hlcd, uint8_t enable, uint32_t shift);
+static void s_reset_gpio     (void);
+#if (USE_GPIO_DMA != 0)
+static volatile uint8_t s_dma_busy = 0; ///?> Кадр выводится через DMA
+#endif
+
+/** @brief Сбрасывает пины шины данных (4 или 8) и управляющие пины
+ *  @note
+ *  	Одна запись BSRR на каждый порт, где есть пины дисплея
+ */
+static void s_reset_gpio(void)
+{
+#define X(port) \
+	if (PORT_DATA_PINS(port) | PORT_CTRL_PINS(port)) \
+		(port)->BSRR = (PORT_DATA_PINS(port) | PORT_CTRL_PINS(port)) << 0x10;
+	LCD_GPIO_PORTS(X)
+#undef X
+}
+
+/// Слово BSRR для значения v: пин бита bit взводится, если бит равен 1, иначе сбрасывается (пин 0 -- ничего)
+#define BSRR_BIT(v, bit, pin) ((((v) >> (bit)) & 1U) ? (uint32_t) (pin) : ((uint32_t) (pin) << 0x10))
+
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+#define BSRR_WORD(v, port) (BSRR_BIT(v, 0, PORT_PIN(D4, port)) | BSRR_BIT(v, 1, PORT_PIN(D5, port)) | \
+                            BSRR_BIT(v, 2, PORT_PIN(D6, port)) | BSRR_BIT(v, 3, PORT_PIN(D7, port)))
+#define BSRR_LUT_SIZE 16
+#define BSRR_LUT(port) BSRR_X16(0, port)
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+#define BSRR_WORD(v, port) (BSRR_BIT(v, 0, PORT_PIN(D0, port)) | BSRR_BIT(v, 1, PORT_PIN(D1, port)) | \
+                            BSRR_BIT(v, 2, PORT_PIN(D2, port)) | BSRR_BIT(v, 3, PORT_PIN(D3, port)) | \
+                            BSRR_BIT(v, 4, PORT_PIN(D4, port)) | BSRR_BIT(v, 5, PORT_PIN(D5, port)) | \
+                            BSRR_BIT(v, 6, PORT_PIN(D6, port)) | BSRR_BIT(v, 7, PORT_PIN(D7, port)))
+#define BSRR_LUT_SIZE 256
+#define BSRR_LUT(port) BSRR_X256(0, port)
+#endif
+
+/// Развёртка таблицы: BSRR_X<n>(base, port) -- n слов BSRR порта port для значений base ... base + n - 1
+#define BSRR_X4(n, p)   BSRR_WORD(n, p), BSRR_WORD((n) + 1, p), BSRR_WORD((n) + 2, p), BSRR_WORD((n) + 3, p)
+#define BSRR_X16(n, p)  BSRR_X4(n, p),  BSRR_X4((n) + 4, p),   BSRR_X4((n) + 8, p),   BSRR_X4((n) + 12, p)
+#define BSRR_X64(n, p)  BSRR_X16(n, p), BSRR_X16((n) + 16, p), BSRR_X16((n) + 32, p), BSRR_X16((n) + 48, p)
+#define BSRR_X256(n, p) BSRR_X64(n, p), BSRR_X64((n) + 64, p), BSRR_X64((n) + 128, p), BSRR_X64((n) + 192, p)
+
+/// Таблицы слов BSRR для всех значений полубайта/байта, по одной на порт из LCD_GPIO_PORTS.
+/// Собираются компилятором из D0_Pin..D7_Pin и D*_GPIO_Port (main.h),
+/// таблицы портов без пинов данных не используются и отбрасываются при сборке
+#define X(port) static const uint32_t s_bsrr_lut_##port[BSRR_LUT_SIZE] = { BSRR_LUT(port) };
+LCD_GPIO_PORTS(X)
+#undef X
+
+/** @brief Слово BSRR пинов шины данных на порту GPIO_PORT
+ *  @note
+ *  	Одна загрузка из таблицы. Используется выводом кадров через DMA,
+ *  	где все пины должны быть на одном порту
+ *  @param [in] data передаваемый байт/полубайт
+ *  @return слово BSRR (установка единичных, сброс нулевых бит)
+ */
+static inline uint32_t s_gpio_word (uint8_t data)
+{
+	uint32_t word = 0;
+#define X(port) \
+	if ((uint32_t) (port) == (uint32_t) GPIO_PORT) \
+		word = s_bsrr_lut_##port[data & (BSRR_LUT_SIZE - 1)];
+	LCD_GPIO_PORTS(X)
+#undef X
+	return word;
+}
+
+#if (LCD_GPIO_BENCHMARK != 0)
+/** @brief Слово BSRR, вычисляемое побитно (прежний способ, для сравнения)
+ *  @param [in] data передаваемый байт/полубайт
+ *  @return слово BSRR
+ */
+static uint32_t s_gpio_word_calc (uint8_t data)
+{
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+    return ((data & 0x01) ? D4_Pin : D4_Pin << 0x10) |
+           ((data & 0x02) ? D5_Pin : D5_Pin << 0x10) |
+           ((data & 0x04) ? D6_Pin : D6_Pin << 0x10) |
+           ((data & 0x08) ? D7_Pin : D7_Pin << 0x10);
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+    return
+		((data & 0x01) ? D0_Pin : D0_Pin << 0x10) |
+		((data & 0x02) ? D1_Pin : D1_Pin << 0x10) |
+		((data & 0x04) ? D2_Pin : D2_Pin << 0x10) |
+		((data & 0x08) ? D3_Pin : D3_Pin << 0x10) |
+		((data & 0x10) ? D4_Pin : D4_Pin << 0x10) |
+		((data & 0x20) ? D5_Pin : D5_Pin << 0x10) |
+		((data & 0x40) ? D6_Pin : D6_Pin << 0x10) |
+		((data & 0x80) ? D7_Pin : D7_Pin << 0x10);
+#endif
+}
+
+/** @brief Замер кодирования слова BSRR: таблица против побитного вычисления
+ *  @note
+ *  	Прогоняет все значения полубайта/байта через оба способа
+ *  	и считает такты DWT->CYCCNT. Результат -- средние такты на
+ *  	одно значение (вместе с записью в volatile-приёмник)
+ *  @param [out] lut  тактов на значение через таблицу
+ *  @param [out] calc тактов на значение при побитном вычислении
+ *  @return None
+ */
+void LCD_GpioBenchmark (uint32_t *lut, uint32_t *calc)
+{
+	volatile uint32_t sink;
+	uint32_t start;
+
+	start = DWT->CYCCNT;
+	for (uint32_t v = 0; v < BSRR_LUT_SIZE; v ++)
+		sink = s_gpio_word((uint8_t) v);
+	*lut = (DWT->CYCCNT - start) / BSRR_LUT_SIZE;
+
+	start = DWT->CYCCNT;
+	for (uint32_t v = 0; v < BSRR_LUT_SIZE; v ++)
+		sink = s_gpio_word_calc((uint8_t) v);
+	*calc = (DWT->CYCCNT - start) / BSRR_LUT_SIZE;
+	(void) sink;
+}
+#endif
+
+/** @brief устанавливает 4/8 GPIO вывода в значения присланного байта/полубайта
+ *  @note
+ *  	В зависимости от выбранной конфигурации
+ *  	LCD_DATA_WIDTH = LCD_DATA_WIDTH_BYTE / LCD_DATA_WIDTH_HALF_BYTE
+ *  	Устанавливает 4 пина в значения бит младшего квартета
+ *  	или 8 пинов в битовые значения всего бита
+ *  	В зависимости от того, выбрана 4 или 8 бит конфигурация
+ *  	Пины
+ *  		D0_Pin -- 8 битная передача
+ *  		D1_Pin -- 8 битная передача
+ *  		D2_Pin -- 8 битная передача
+ *  		D3_Pin -- 8 битная передача
+ *  		D4_Pin -- 8/4 битная передача
+ *  		D5_Pin -- 8/4 битная передача
+ *  		D6_Pin -- 8/4 битная передача
+ *  		D7_Pin -- 8/4 битная передача
+ *  	вместе с RS_Pin могут быть на любых портах из LCD_GPIO_PORTS.
+ *  	На каждый порт с пинами данных или RS -- одна запись BSRR
+ *  	Для 8 битного режима передачи надо 10 пинов
+ *  	Для 4 битного режима передачи надо 6 пинов
+ *  @param [in] data передаваемый байт/полубайт
+ *  @param [in] rs   1 -- взвести RS (данные), 0 -- не трогать (команда)
+ *  @return None
+ */
+static void s_set_gpio (uint8_t data, uint8_t rs)
+{
+    // Установка необходимых бит данных и RS, по записи на порт
+#define X(port) \
+	if (PORT_DATA_PINS(port) | PORT_PIN(RS, port)) \
+		(port)->BSRR = s_bsrr_lut_##port[data & (BSRR_LUT_SIZE - 1)] | (rs ? PORT_PIN(RS, port) : 0U);
+	LCD_GPIO_PORTS(X)
+#undef X
+}
+
+/** @brief Взводит (shift = 0) или сбрасывает (shift = 0x10) стробы E
+ *  @note
+ *  	Стробы выбранных контроллеров меняются одновременно,
+ *  	если E1 и E2 на одном порту (одна запись в BSRR)
+ *  @param [in] hlcd   дескриптор дисплея
+ *  @param [in] enable маска контроллеров LCD_ENABLE_E1/E2
+ *  @param [in] shift  0 -- взвести, 0x10 -- сбросить
+ *  @return None
+ */
+static inline void s_strobe (LCD_HandleTypeDef *hlcd, uint8_t enable, uint32_t shift)
+{
+	uint32_t e1 = (enable & LCD_ENABLE_E1) ? hlcd->EPin  : 0;
+	uint32_t e2 = (enable & LCD_ENABLE_E2) ? hlcd->E2Pin : 0;
+	if (hlcd->E2Port == hlcd->EPort)
+	{
+		hlcd->EPort->BSRR = (e1 | e2) << shift;
+		return;
+	}
+	if (e1)
+		hlcd->EPort->BSRR = e1 << shift;
+	if (e2)
+		hlcd->E2Port->BSRR = e2 << shift;
+}
+
+/** @brief Отправляет байт через пины
+ *  @note
+ *  	Стробирует E выбранных контроллеров дисплея hlcd (hlcd->Enable)
+ *  	Сначала выставляются данные и RS на всех портах, через tAS
+ *  	от последней записи взводится E, через PWEH сбрасывается,
+ *  	затем выдерживается остаток цикла tcycE и сбрасывается RS.
+ *  	Задержки отсчитываются счётчиком тактов DWT (lcd_delay.h)
+ *  	Используется как для отправки полубайта, так и для отправки байта
+ *  @return None
+ */
+static void s_transport_byte (LCD_HandleTypeDef *hlcd, uint8_t data, uint8_t rs)
+{
+	s_set_gpio (data, rs);          // Данные и RS, E ещё сброшен
+	LCD_DelayNs(LCD_T_AS_NS);
+	s_strobe(hlcd, hlcd->Enable, 0); // Строб
+	LCD_DelayNs(LCD_T_PWEH_NS);
+	s_strobe(hlcd, hlcd->Enable, 0x10);
+	LCD_DelayNs(LCD_T_CYCE_NS - LCD_T_PWEH_NS - LCD_T_AS_NS);
+	if (rs)
+		RS_GPIO_Port->BSRR = RS_Pin << 0x10;
+}
+
+/** @brief Отправляет байт, как данные (Взводится линия RS)
+ *  @note
+ *  	E_Pin стробирует передачу байта/полубайта
+ *  @return None
+ */
+static void s_send_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+#if (USE_GPIO_DMA != 0)
+	while (s_dma_busy)
+		; // Дождаться конца кадра DMA
+#endif
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	s_transport_byte (hlcd, data, 1);
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+    s_transport_byte(hlcd, data >> 4, 1);
+    s_transport_byte(hlcd, data, 1);
+#endif
+}
+
+/** @brief Отправляет байт, как команду (Линия RS не стробируется)
+ *  @note
+ *  	RS_Pin -- не стробируется
+ *  	E_Pin  -- стробируется
+ *  @return None
+ */
+static void s_send_command (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+#if (USE_GPIO_DMA != 0)
+	while (s_dma_busy)
+		; // Дождаться конца кадра DMA
+#endif
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	s_transport_byte (hlcd, data, 0);
+#elif (LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+    s_transport_byte (hlcd, (data >> 4) & 0x0F, 0);
+    s_transport_byte (hlcd, data & 0x0F, 0);
+#endif
+}
+
+#if (USE_BUSY_FLAG != 0)
+/// Маска полей MODER для маски пинов p (по два бита на пин), вычисляется компилятором
+#define MODER_FIELD(p, i) ((((p) >> (i)) & 1UL) * (0x03UL << ((i) * 2)))
+#define MODER_MASK(p) (MODER_FIELD(p, 0)  | MODER_FIELD(p, 1)  | MODER_FIELD(p, 2)  | MODER_FIELD(p, 3)  | \
+                       MODER_FIELD(p, 4)  | MODER_FIELD(p, 5)  | MODER_FIELD(p, 6)  | MODER_FIELD(p, 7)  | \
+                       MODER_FIELD(p, 8)  | MODER_FIELD(p, 9)  | MODER_FIELD(p, 10) | MODER_FIELD(p, 11) | \
+                       MODER_FIELD(p, 12) | MODER_FIELD(p, 13) | MODER_FIELD(p, 14) | MODER_FIELD(p, 15))
+#define MODER_OUT(p)  (MODER_MASK(p) & 0x55555555UL) ///?> Поля MODER пинов p в режиме выхода
+
+/** @brief Ожидание сброса флага занятости BF (D7)
+ *  @note
+ *  	Пины шины данных переключаются на вход, RS сбрасывается,
+ *  	RW взводится, и E стробируется, пока контроллер держит BF.
+ *  	В 4-битном режиме регистр читается двумя полубайтами,
+ *  	второй строб только дочитывает младшие биты AC.
+ *  	Пины порта D толерантны к 5 В, поэтому чтение с 5-вольтового
+ *  	дисплея допустимо (для других портов проверить FT в документации).
+ *  	Ожидание ограничено LCD_BUSY_TIMEOUT_MS,
+ *  	чтобы не зависнуть, если линия RW не подключена.
+ *  	Контроллеры 40x4 и дисплеи массива (несколько пинов в EPin)
+ *  	опрашиваются по очереди: при общем стробе все выдали бы BF
+ *  	на одну шину D7. Пока DMA выводит кадр (любого дисплея на той же
+ *  	шине), шину данных на вход не переключить -- сначала ждём конца кадра
+ *  @param [in] hlcd   дескриптор дисплея (стробы E1/E2)
+ *  @param [in] enable маска опрашиваемых контроллеров LCD_ENABLE_E1/E2
+ *  @return None
+ */
+static void s_wait_busy (LCD_HandleTypeDef *hlcd, uint8_t enable)
+{
+	uint32_t start;
+	uint32_t busy;
+
+#if (USE_GPIO_DMA != 0)
+	while (s_dma_busy)
+		; // Шина данных общая: кадр этого или другого дисплея ещё выводится
+#endif
+	start = HAL_GetTick();
+#define X(port) \
+	if (PORT_DATA_PINS(port)) \
+		(port)->MODER &= ~MODER_MASK(PORT_DATA_PINS(port)); // Шина данных -- на вход
+	LCD_GPIO_PORTS(X)
+#undef X
+	if (RW_GPIO_Port == RS_GPIO_Port)
+		RW_GPIO_Port->BSRR = RW_Pin | (RS_Pin << 0x10); // Чтение регистра состояния
+	else
+	{
+		RS_GPIO_Port->BSRR = RS_Pin << 0x10;
+		RW_GPIO_Port->BSRR = RW_Pin;
+	}
+	LCD_DelayNs(LCD_T_AS_NS);
+	for (uint8_t e = LCD_ENABLE_E1; e <= LCD_ENABLE_E2; e <<= 1)
+	{
+		if (!(enable & e))
+			continue;
+		GPIO_TypeDef *port = (e == LCD_ENABLE_E1) ? hlcd->EPort : hlcd->E2Port;
+		uint32_t pins = (e == LCD_ENABLE_E1) ? hlcd->EPin : hlcd->E2Pin;
+		for (uint32_t pin = pins & -pins; pin; pins &= ~pin, pin = pins & -pins)
+		{
+			do
+			{
+				port->BSRR = pin;
+				LCD_DelayNs(LCD_T_PWEH_NS);
+				busy = D7_GPIO_Port->IDR & D7_Pin;
+				port->BSRR = pin << 0x10;
+				LCD_DelayNs(LCD_T_CYCE_NS - LCD_T_PWEH_NS);
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+				port->BSRR = pin;                          // Младший полубайт (AC0-AC3)
+				LCD_DelayNs(LCD_T_PWEH_NS);
+				port->BSRR = pin << 0x10;
+				LCD_DelayNs(LCD_T_CYCE_NS - LCD_T_PWEH_NS);
+#endif
+			} while (busy && (HAL_GetTick() - start) < LCD_BUSY_TIMEOUT_MS);
+		}
+	}
+
+	RW_GPIO_Port->BSRR = RW_Pin << 0x10;                // Обратно в режим записи
+#define X(port) \
+	if (PORT_DATA_PINS(port)) \
+		(port)->MODER = ((port)->MODER & ~MODER_MASK(PORT_DATA_PINS(port))) | MODER_OUT(PORT_DATA_PINS(port));
+	LCD_GPIO_PORTS(X)
+#undef X
+}
+#endif
+
+#if (USE_GPIO_DMA != 0)
+#define DMA_STREAM      DMA2_Stream5 ///?> Поток DMA2, канал 6 -- запрос TIM1_UP
+#define DMA_CHANNEL     6
+#define DMA_FLAGS       (DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5)
+
+static uint32_t s_bsrr_frame[LCD_GPIO_DMA_FRAME_WORDS]; ///?> Кадр: слова BSRR, по одному на такт TIM1
+static uint16_t s_bsrr_len = 0;                         ///?> Число слов в кадре
+static LCD_HandleTypeDef *s_dma_owner = NULL;           ///?> Дисплей, чей кадр заполняется или выводится
+
+static void s_frame_begin (LCD_HandleTypeDef *hlcd);
+static void s_frame_end   (LCD_HandleTypeDef *hlcd);
+
+/** @brief Настройка TIM1 и DMA2 Stream5 для вывода кадра в BSRR
+ *  @note
+ *  	Каждое событие обновления TIM1 (период LCD_GPIO_DMA_TICK_NS)
+ *  	запрашивает у DMA перенос одного слова из кадра в GPIO_PORT->BSRR.
+ *  	DMA1 к шине AHB1 (GPIO) доступа не имеет, поэтому только DMA2
+ *  @return None
+ */
+static void s_dma_init (void)
+{
+	static uint8_t ready = 0;
+	if (ready)
+		return;
+	ready = 1;
+
+	uint32_t clock = HAL_RCC_GetPCLK2Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1)
+		clock *= 2; // Таймеры APB2 тактируются удвоенной частотой шины
+
+	__HAL_RCC_TIM1_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+
+	TIM1->CR1  = 0;
+	TIM1->PSC  = 0;
+	TIM1->ARR  = (clock / 1000000U) * LCD_GPIO_DMA_TICK_NS / 1000U - 1;
+	TIM1->DIER = TIM_DIER_UDE;           // Запрос DMA по обновлению
+
+	DMA_STREAM->CR  = 0;
+	DMA_STREAM->PAR = (uint32_t) &GPIO_PORT->BSRR;
+	DMA_STREAM->CR  = (DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) |
+	                  DMA_SxCR_PL_1 |                      // Высокий приоритет
+	                  DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | // Слова 32 бита
+	                  DMA_SxCR_MINC |                      // Инкремент по памяти
+	                  DMA_SxCR_DIR_0 |                     // Память -> периферия
+	                  DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+	HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, LCD_GPIO_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+}
+
+/** @brief Запуск вывода накопленного кадра
+ *  @return None
+ */
+static void s_dma_start (void)
+{
+	s_dma_busy = 1;
+	DMA2->HIFCR       = DMA_FLAGS;
+	DMA_STREAM->M0AR  = (uint32_t) s_bsrr_frame;
+	DMA_STREAM->NDTR  = s_bsrr_len;
+	DMA_STREAM->CR   |= DMA_SxCR_EN;
+	TIM1->CNT  = 0;
+	TIM1->CR1 |= TIM_CR1_CEN;
+}
+
+/** @brief Добавляет в кадр передачу байта/полубайта
+ *  @note
+ *  	Три такта: данные и RS при сброшенном E (tAS), взведённый E (PWEH),
+ *  	сброшенный E. Затем пустые слова BSRR (0 -- без изменений)
+ *  	на время выполнения инструкции
+ *  @param [in] e    пин строба E дисплея (на порту GPIO_PORT)
+ *  @param [in] data байт/полубайт
+ *  @param [in] add  RS_Pin для данных, 0 для команды
+ *  @return None
+ */
+static inline void s_frame_nibble (uint32_t e, uint8_t data, uint32_t add)
+{
+	s_bsrr_frame[s_bsrr_len ++] = s_gpio_word(data) | (add ? RS_Pin : (RS_Pin << 0x10)) | (e << 0x10);
+	s_bsrr_frame[s_bsrr_len ++] = e;
+	s_bsrr_frame[s_bsrr_len ++] = e << 0x10;
+}
+
+/** @brief Добавляет в кадр инструкцию и паузу на её выполнение
+ *  @note
+ *  	Если инструкция не помещается, текущий кадр выводится
+ *  	и кадр начинается заново (с ожиданием конца вывода).
+ *  	Пауза длиннее пустого кадра (очистка при коротком такте)
+ *  	продолжается в следующем кадре: он начнётся только после
+ *  	вывода этого, поэтому пауза не сокращается
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт команды/данных
+ *  @param [in] add  RS_Pin для данных, 0 для команды
+ *  @param [in] us   время выполнения инструкции, мкс
+ *  @return None
+ */
+static void s_frame_op (LCD_HandleTypeDef *hlcd, uint8_t data, uint32_t add, uint32_t us)
+{
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+	const uint32_t strobe = 6;
+#else
+	const uint32_t strobe = 3;
+#endif
+	uint32_t e = ((hlcd->Enable & LCD_ENABLE_E1) ? hlcd->EPin  : 0) |
+	             ((hlcd->Enable & LCD_ENABLE_E2) ? hlcd->E2Pin : 0);
+	uint32_t idle = (us * 1000U + LCD_GPIO_DMA_TICK_NS - 1) / LCD_GPIO_DMA_TICK_NS;
+	if (s_bsrr_len + strobe + idle > LCD_GPIO_DMA_FRAME_WORDS)
+	{
+		s_frame_end(hlcd);
+		s_frame_begin(hlcd);
+	}
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_HALF_BYTE)
+	s_frame_nibble(e, data >> 4, add);
+	s_frame_nibble(e, data & 0x0F, add);
+#else
+	s_frame_nibble(e, data, add);
+#endif
+	while (idle --)
+	{
+		if (s_bsrr_len >= LCD_GPIO_DMA_FRAME_WORDS)
+		{
+			s_frame_end(hlcd);
+			s_frame_begin(hlcd);
+		}
+		s_bsrr_frame[s_bsrr_len ++] = 0;
+	}
+}
+
+/** @brief Начало кадра
+ *  @note
+ *  	Буфер кадра один на все дисплеи, поэтому ждёт окончания
+ *  	вывода предыдущего. Кадры разных дисплеев не перемежаются
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_begin (LCD_HandleTypeDef *hlcd)
+{
+	while (s_dma_busy)
+		;
+	s_dma_owner = hlcd;
+	s_bsrr_len = 0;
+}
+
+/** @brief Добавляет в кадр команду
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] cmd  код команды
+ *  @return None
+ */
+static void s_frame_command (LCD_HandleTypeDef *hlcd, uint8_t cmd)
+{
+	s_frame_op(hlcd, cmd, 0, LCD_InstrTimeUs(LCD_InstrClassify(cmd)));
+}
+
+/** @brief Добавляет в кадр байт данных
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт данных
+ *  @return None
+ */
+static void s_frame_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+	s_frame_op(hlcd, data, RS_Pin, LCD_InstrTimeUs(LCD_INSTR_DATA));
+}
+
+/** @brief Запускает вывод кадра через DMA и сразу возвращается
+ *  @note
+ *  	По окончании вызывается LCD_FrameCompleteCallback (из прерывания)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_end (LCD_HandleTypeDef *hlcd)
+{
+	if (s_bsrr_len == 0)
+	{
+		LCD_FrameCompleteCallback(hlcd);
+		return;
+	}
+	s_dma_start();
+}
+
+/** @brief Проверка, что кадр дисплея ещё выводится
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- DMA выводит кадр этого дисплея, 0 -- свободен
+ */
+static uint8_t s_frame_busy (LCD_HandleTypeDef *hlcd)
+{
+	return s_dma_busy && (s_dma_owner == hlcd);
+}
+
+/** @brief Обработчик прерывания DMA2 Stream5: конец вывода кадра
+ *  @note
+ *  	Вызывается из DMA2_Stream5_IRQHandler (stm32f4xx_it.c)
+ *  @return None
+ */
+void LCD_GpioDmaIRQHandler (void)
+{
+	uint32_t flags = DMA2->HISR;
+	DMA2->HIFCR = DMA_FLAGS;
+	if (flags & (DMA_HISR_TCIF5 | DMA_HISR_TEIF5))
+	{
+		TIM1->CR1 &= ~TIM_CR1_CEN;
+		DMA_STREAM->CR &= ~DMA_SxCR_EN;
+		s_dma_busy = 0;
+		LCD_FrameCompleteCallback(s_dma_owner);
+	}
+}
+#endif
+
+/** @brief Предварительный сброс управляющих пинов RS, RW, E и пинов даннных D0-D7
+ *  @note
+ *  	Если строб E дисплея не задан, берётся E_Pin из main.h.
+ *  	Дисплею с двумя контроллерами (40x4) нужен ещё строб E2.
+ *  	Пины дисплея настраиваются на выход в MX_GPIO_Init.
+ *  	Для вывода кадров через DMA проверяет, что все пины
+ *  	дисплея на одном порту (GPIO_PORT)
+ *  @param [in] hlcd дескриптор дисплея
+ *	@return None
+ */
+static void s_transport_init (LCD_HandleTypeDef *hlcd)
+{
+	if (hlcd->EPort == NULL)
+	{
+		hlcd->EPort = E_GPIO_Port;
+		hlcd->EPin  = E_Pin;
+	}
+	if (hlcd->Geometry->E2Row && hlcd->E2Port == NULL)
+	{
+		Error_Handler(); // Второй контроллер не подключён
+	}
+	s_reset_gpio();
+	s_strobe(hlcd, LCD_ENABLE_BOTH, 0x10);
+#if (USE_GPIO_DMA != 0)
+#define ON_PORT(name) ((uint32_t) name##_GPIO_Port == (uint32_t) GPIO_PORT)
+#if	(LCD_DATA_WIDTH == LCD_DATA_WIDTH_BYTE)
+	if (!(ON_PORT(D0) && ON_PORT(D1) && ON_PORT(D2) && ON_PORT(D3)) ||
+		!(ON_PORT(D5) && ON_PORT(D6) && ON_PORT(D7) && ON_PORT(RS)) || hlcd->EPort != GPIO_PORT ||
+		(hlcd->E2Port != NULL && hlcd->E2Port != GPIO_PORT))
+#else
+	if (!(ON_PORT(D5) && ON_PORT(D6) && ON_PORT(D7) && ON_PORT(RS)) || hlcd->EPort != GPIO_PORT ||
+		(hlcd->E2Port != NULL && hlcd->E2Port != GPIO_PORT))
+#endif
+#undef ON_PORT
+	{
+		Error_Handler(); // Кадр DMA пишет в BSRR одного порта
+	}
+	s_dma_init ();
+#endif
+}
+
+/// Операции транспорта GPIO
+const LCD_TransportTypeDef LCD_TransportGpio = {
+	.Width        = LCD_DATA_WIDTH,
+	.Init         = s_transport_init,
+	.SendCommand  = s_send_command,
+	.SendData     = s_send_data,
+#if (USE_BUSY_FLAG != 0)
+	.WaitReady    = s_wait_busy,
+#endif
+#if (USE_GPIO_DMA != 0)
+	.FrameBegin   = s_frame_begin,
+	.FrameCommand = s_frame_command,
+	.FrameData    = s_frame_data,
+	.FrameEnd     = s_frame_end,
+	.FrameBusy    = s_frame_busy,
+#endif
+};
+#endif
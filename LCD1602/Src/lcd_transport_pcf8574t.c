@@ -0,0 +1,676 @@
+/*
+ * lcd_transport_pcf8574t.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include "lcd1602.h"
+
+#if (LCD_DATA_TRANSPORT_PCF8574T != 0)
+
+#include "i2c.h"
+
+/// У каждого дисплея своя шина (LCD_HandleTypeDef::Bus) и адрес
+/// (LCD_HandleTypeDef::Address), буферы кадра -- в контексте из пула.
+/// Через PCF8574T шина данных всегда 4-битная
+
+#define PCF8574T_I2C_ADDR 0x27 ///?> Адрес по умолчанию (A0-A2 подтянуты)
+#define RS_Bit  0 ///?> Если на пине RS -- 0, данные воспринимаются как команда, если 1 - как символы для вывода
+#define RW_Bit  1 ///?> Пин записи данных в память LCD1602
+#define EN_Bit  2 ///?> Строб данных на пинах LCD1602
+#define BKL_Bit 3 ///?> Пин подсветки
+
+
+#define RS_MSK    (1 << RS_Bit)  ///?> Маска строба данных/команды
+#define RW_MSK    (1 << RW_Bit)  ///?> Строб записи данных в память LCD1602
+#define EN_MSK    (1 << EN_Bit)  ///?> Строб передачи данных на GPIO дисплея LCD1602
+#define BKL_MSK   (1 << BKL_Bit) ///?> Управление подсветкой (BackLight)
+
+/// Стробы выбранных контроллеров дисплея. У дисплея 40x4 строб E2
+/// подключается к выводу RW (P1) PCF8574T, а RW модуля -- на землю
+/// (транспорт только пишет, BF не читается)
+#define EN_MASK(hlcd) ((((hlcd)->Enable & LCD_ENABLE_E1) ? EN_MSK : 0) | (((hlcd)->Enable & LCD_ENABLE_E2) ? RW_MSK : 0))
+
+#define HI2C_DEVICE_HANDLER hi2c1 ///?> идентификатор I2C по умолчанию
+#define I2C_TIMEOUT_MS      100   ///?> Предельное время одной транзакции I2C, мс
+
+#if (LCD_PCF8574T_DMA != 0)
+#define I2C_FRAME_BUFFERS 2 ///?> Двойной буфер: один кадр уходит через DMA, второй заполняется
+#else
+#define I2C_FRAME_BUFFERS 1
+#endif
+
+/// Состояние транспорта одного дисплея
+typedef struct {
+	LCD_HandleTypeDef *hlcd;                                      ///?> Дисплей
+	I2C_HandleTypeDef *hi2c;                                      ///?> Шина
+	uint16_t           addr;                                      ///?> Адрес I2C, сдвинутый на 1 бит влево (как принимает HAL)
+	uint8_t            frame[I2C_FRAME_BUFFERS][LCD_PCF8574T_FRAME_SIZE]; ///?> Кадры: байты PCF8574T для одной транзакции
+	uint16_t           len;                                       ///?> Число байт в заполняемом кадре
+	uint8_t            fill;                                      ///?> Номер заполняемого буфера кадра
+	uint32_t           byte_ns;                                   ///?> Время передачи одного байта по I2C (9 тактов SCL), нс
+	volatile uint8_t   error;                                     ///?> Последняя передача через DMA завершилась ошибкой
+	volatile uint8_t   queued;                                    ///?> Кадров в очереди шины и в передаче
+	uint8_t            bus;                                       ///?> Номер шины в s_i2c_bus (кадры через DMA)
+} pcf_ctx_t;
+
+static void     s_transmit       (pcf_ctx_t *ctx, uint8_t *buf, uint16_t len);
+static uint8_t *s_encode_8bit    (uint8_t *buf, uint8_t data, uint8_t add, uint8_t en);
+static uint8_t *s_encode_2x4bit  (uint8_t *buf, uint8_t data, uint8_t add, uint8_t en);
+static void     s_send_2x4bit    (pcf_ctx_t *ctx, uint8_t data, uint8_t add);
+static void     s_frame_begin    (LCD_HandleTypeDef *hlcd);
+static void     s_frame_end      (LCD_HandleTypeDef *hlcd);
+static void     s_frame_command  (LCD_HandleTypeDef *hlcd, uint8_t cmd);
+
+static pcf_ctx_t s_ctx[LCD_PCF8574T_INSTANCES]; ///?> Пул контекстов дисплеев
+static uint8_t   s_ctx_count = 0;               ///?> Число занятых контекстов
+#if (LCD_PCF8574T_DMA != 0)
+/// Готовый кадр в очереди шины
+typedef struct {
+	pcf_ctx_t *ctx; ///?> Дисплей
+	uint8_t    buf; ///?> Буфер кадра
+	uint16_t   len; ///?> Число байт
+} i2c_job_t;
+
+#define I2C_BUSES      3 ///?> I2C1, I2C2, I2C3
+#define I2C_QUEUE_SIZE (LCD_PCF8574T_INSTANCES * I2C_FRAME_BUFFERS) ///?> Больше кадров, чем буферов, не бывает
+
+/// Поток DMA1 и прерывания контроллера I2C (RM0090, таблица запросов DMA1)
+typedef struct {
+	I2C_TypeDef        *instance; ///?> Контроллер I2C
+	DMA_Stream_TypeDef *stream;   ///?> Поток DMA1 запроса I2Cx_TX
+	uint32_t            channel;  ///?> Канал потока
+	IRQn_Type           dma_irq;  ///?> Прерывание потока
+	IRQn_Type           ev_irq;   ///?> Прерывание событий I2C
+	IRQn_Type           er_irq;   ///?> Прерывание ошибок I2C
+} i2c_hw_t;
+
+static const i2c_hw_t s_i2c_hw[I2C_BUSES] = {
+	{ I2C1, DMA1_Stream6, DMA_CHANNEL_1, DMA1_Stream6_IRQn, I2C1_EV_IRQn, I2C1_ER_IRQn },
+	{ I2C2, DMA1_Stream7, DMA_CHANNEL_7, DMA1_Stream7_IRQn, I2C2_EV_IRQn, I2C2_ER_IRQn },
+	{ I2C3, DMA1_Stream4, DMA_CHANNEL_3, DMA1_Stream4_IRQn, I2C3_EV_IRQn, I2C3_ER_IRQn },
+};
+
+/// Состояние шины: поток DMA и очередь кадров её дисплеев.
+/// Шины независимы, кадры разных шин передаются одновременно
+typedef struct {
+	I2C_HandleTypeDef  *hi2c;                  ///?> Дескриптор HAL шины, NULL -- шина не используется
+	DMA_HandleTypeDef   hdma;                  ///?> Поток DMA I2Cx_TX
+	pcf_ctx_t *volatile owner;                 ///?> Дисплей, чей кадр передаётся (NULL -- шина свободна)
+	i2c_job_t           queue[I2C_QUEUE_SIZE]; ///?> Кадры дисплеев в порядке FrameEnd
+	volatile uint8_t    head;                  ///?> Индекс записи (основной цикл, при запрещённых прерываниях)
+	volatile uint8_t    tail;                  ///?> Индекс чтения (прерывание окончания передачи)
+} i2c_bus_t;
+
+static i2c_bus_t s_i2c_bus[I2C_BUSES]; ///?> Шины по номеру контроллера
+
+static void       s_i2c_bus_init (pcf_ctx_t *ctx);
+static i2c_bus_t *s_i2c_find     (I2C_HandleTypeDef *hi2c);
+static void       s_i2c_next     (i2c_bus_t *bus);
+#endif
+
+/** @brief Отправляет байт, как данные (Линия RS стробируется)
+ *  @note
+ *  	RS_Bit -- стробируется
+ *  	E_Bit  -- стробирует передачу байта/полубайта
+ *  	Старший квартет -- данные, младший -- управляющие биты (E, RS)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param data (uint8_t)
+ *  @return None
+ */
+static void s_send_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+	s_send_2x4bit((pcf_ctx_t *) hlcd->Context, data, RS_MSK); // Отправить данные разбив два квартета (в старшем полубайте)
+}
+
+/** @brief Отправляет байт, как команду (Линия RS не стробируется)
+ *  @note
+ *  		RS_Bit -- не стробируется
+ *  		EN_Bit  -- стробирует передачу байта/полубайта
+ *  	Старший квартет -- данные, младший -- управляющие биты (E, RS, RW)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param data (uint8_t) данные для отправки
+ *  @return None
+ */
+static void s_send_command (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+	s_send_2x4bit((pcf_ctx_t *) hlcd->Context, data, 0); // Отправить команду, разбив на два квартета в старшем полубайте
+}
+
+/** @brief Проверка присутствия PCF8574T на шине
+ *  @note
+ *  	Дисплею выделяется контекст из пула (при повторной
+ *  	инициализации -- прежний). Шина по умолчанию -- hi2c1,
+ *  	адрес -- 0x27. Кадры через DMA передаются по любой из шин
+ *  	I2C1-I2C3, у каждой свой поток DMA1 и своя очередь кадров.
+ *  	Адресная проба выполняется один раз здесь и повторно
+ *  	только после ошибки передачи (s_transmit, s_recover)
+ *  	Время передачи байта нужно, чтобы выдерживать время выполнения
+ *  	инструкций внутри одной транзакции
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_transport_init (LCD_HandleTypeDef *hlcd)
+{
+	pcf_ctx_t *ctx = (pcf_ctx_t *) hlcd->Context;
+	if (ctx == NULL)
+	{
+		if (s_ctx_count >= LCD_PCF8574T_INSTANCES)
+		{
+			Error_Handler();
+		}
+		ctx = &s_ctx[s_ctx_count ++];
+		hlcd->Context = ctx;
+	}
+	if (hlcd->Bus == NULL)
+		hlcd->Bus = & HI2C_DEVICE_HANDLER;
+	if (hlcd->Address == 0)
+		hlcd->Address = PCF8574T_I2C_ADDR;
+	ctx->hlcd = hlcd;
+	ctx->hi2c = (I2C_HandleTypeDef *) hlcd->Bus;
+	ctx->addr = (uint16_t) (hlcd->Address << 1);
+	ctx->len  = 0;
+
+	if (HAL_I2C_IsDeviceReady(ctx->hi2c, ctx->addr, 10, I2C_TIMEOUT_MS) != HAL_OK)
+	{
+		Error_Handler();
+	}
+	ctx->byte_ns = 9U * 1000000U / (ctx->hi2c->Init.ClockSpeed / 1000U);
+#if (LCD_PCF8574T_DMA != 0)
+	s_i2c_bus_init(ctx);
+#endif
+}
+
+#if (LCD_PCF8574T_DMA != 0)
+/** @brief Привязка дисплея к шине и настройка её потока DMA
+ *  @note
+ *  	Поток DMA1 и прерывания шины настраиваются при первом
+ *  	дисплее на ней. Контроллер I2C берётся из дескриптора HAL,
+ *  	сам контроллер (MX_I2Cx_Init) настраивает приложение.
+ *  	I2C1_TX -- Stream6 канал 1, I2C2_TX -- Stream7 канал 7,
+ *  	I2C3_TX -- Stream4 канал 3
+ *  @param [in] ctx контекст дисплея
+ *  @return None
+ */
+static void s_i2c_bus_init (pcf_ctx_t *ctx)
+{
+	uint8_t k = 0;
+	while (k < I2C_BUSES && s_i2c_hw[k].instance != ctx->hi2c->Instance)
+		k ++;
+	if (k >= I2C_BUSES)
+	{
+		Error_Handler();
+	}
+	ctx->bus = k;
+	i2c_bus_t *bus = &s_i2c_bus[k];
+	const i2c_hw_t *hw = &s_i2c_hw[k];
+	if (bus->hi2c != NULL)
+	{
+		if (bus->hi2c != ctx->hi2c)
+		{
+			Error_Handler(); // Два дескриптора HAL на один контроллер
+		}
+		return; // DMA уже настроен для другого дисплея на этой шине
+	}
+	bus->hi2c = ctx->hi2c;
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	bus->hdma.Instance                 = hw->stream;
+	bus->hdma.Init.Channel             = hw->channel;
+	bus->hdma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	bus->hdma.Init.PeriphInc           = DMA_PINC_DISABLE;
+	bus->hdma.Init.MemInc              = DMA_MINC_ENABLE;
+	bus->hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	bus->hdma.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	bus->hdma.Init.Mode                = DMA_NORMAL;
+	bus->hdma.Init.Priority            = DMA_PRIORITY_LOW;
+	bus->hdma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+	if (HAL_DMA_Init(&bus->hdma) != HAL_OK)
+	{
+		Error_Handler();
+	}
+	__HAL_LINKDMA(bus->hi2c, hdmatx, bus->hdma);
+
+	HAL_NVIC_SetPriority(hw->dma_irq, LCD_PCF8574T_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(hw->dma_irq);
+	HAL_NVIC_SetPriority(hw->ev_irq, LCD_PCF8574T_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(hw->ev_irq);
+	HAL_NVIC_SetPriority(hw->er_irq, LCD_PCF8574T_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(hw->er_irq);
+}
+#endif
+
+/** @brief Кодирует 8 бит со стробированием E и add (если != 0)
+ *  @note
+ *  	Кодирует 8 бит вне зависимости от режима передачи 8/4 бита данных
+ *  	Первый байт взводит стробы en, второй сбрасывает; add (RS) держится
+ *  	в обоих байтах, чтобы не менять RS одновременно со спадом E
+ *  	add передавать уже со смещением (маска, MSK)
+ *  @param [out] buf  буфер, в который пишутся 2 байта
+ *  @param [in]  en   стробы контроллеров (EN_MASK)
+ *	@return указатель на следующий свободный байт буфера
+ */
+static uint8_t *s_encode_8bit (uint8_t *buf, uint8_t data, uint8_t add, uint8_t en)
+{
+	*buf ++ = data | BKL_MSK | en | add;
+	*buf ++ = data | BKL_MSK | add;
+	return buf;
+}
+
+/** @brief Кодирует байт в 4-битном режиме передачи данных
+ *  @note
+ *  	В режиме данных 4 бита разбивает данные на 2 квартета,
+ *  	каждый из которых передаётся двумя байтами PCF8574T
+ *  		в которых:
+ *  			1. старший квартет -- данные,
+ *  			2. младший квартет -- управляющие биты (LCD1602)
+ *  	add может содержать
+ *  		E_Bit  -- Строб передачи данных
+ *  		RS_Bit -- Строб передачи команды
+ *  		RW_Bit -- Строб записи в память (например, символа)
+ *  	D4, D5, D6, D7                 -- для 4битной передачи
+ *  @param [out] buf  буфер, в который пишутся 4 байта
+ *  @param [in]  en   стробы контроллеров (EN_MASK)
+ *  @return указатель на следующий свободный байт буфера
+ */
+static uint8_t *s_encode_2x4bit (uint8_t *buf, uint8_t data, uint8_t add, uint8_t en)
+{
+	// Старший квартет данных и добавочные данные в младшем полубайте
+    buf = s_encode_8bit(buf, (data) & 0xF0, add, en);
+    // Младший квартет данных в старшем квартете
+    return s_encode_8bit(buf, (data << 4) & 0xF0, add, en);
+}
+
+/** @brief Отправляет байт в 4-битном режиме одной транзакцией I2C
+ *  @return None
+ */
+static void s_send_2x4bit (pcf_ctx_t *ctx, uint8_t data, uint8_t add)
+{
+	uint8_t buf[4];
+	s_encode_2x4bit(buf, data, add, EN_MASK(ctx->hlcd));
+	s_transmit(ctx, buf, sizeof(buf));
+}
+
+/** @brief Время передачи байта дисплею по I2C
+ *  @note
+ *  	Байт -- два квартета по два байта PCF8574T (s_encode_2x4bit),
+ *  	адресная фаза транзакции делится на весь кадр и не учитывается
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return время, нс
+ */
+static uint32_t s_byte_time_ns (LCD_HandleTypeDef *hlcd)
+{
+	return 4U * ((pcf_ctx_t *) hlcd->Context)->byte_ns;
+}
+
+/** @brief Отправка буфера одной транзакцией I2C
+ *	@note
+ *		PCF8574T защёлкивает каждый байт многобайтной записи,
+ *		поэтому весь буфер уходит с одной адресной фазой.
+ *		При ошибке устройство проверяется заново и передача
+ *		повторяется один раз
+ *	@param [in] ctx контекст дисплея
+ *	@param [in] buf буфер
+ *	@param [in] len число байт
+ *	@return None
+ */
+static void s_transmit (pcf_ctx_t *ctx, uint8_t *buf, uint16_t len)
+{
+#if (LCD_PCF8574T_DMA != 0)
+	while (s_i2c_bus[ctx->bus].owner)
+		; // Дождаться конца кадров DMA на шине
+#endif
+	if (HAL_I2C_Master_Transmit(ctx->hi2c, ctx->addr, buf, len, I2C_TIMEOUT_MS) == HAL_OK)
+		return;
+	if (HAL_I2C_IsDeviceReady(ctx->hi2c, ctx->addr, 10, I2C_TIMEOUT_MS) != HAL_OK ||
+		HAL_I2C_Master_Transmit(ctx->hi2c, ctx->addr, buf, len, I2C_TIMEOUT_MS) != HAL_OK)
+	{
+		Error_Handler();
+	}
+}
+
+/** @brief Добавляет в кадр инструкцию и паузу на её выполнение
+ *  @note
+ *  	Пауза -- повтор байта с неизменными выводами (E сброшен)
+ *  	столько раз, чтобы передача по I2C заняла не меньше времени
+ *  	выполнения инструкции. На 100 КГц байт идёт 90 мкс, поэтому
+ *  	для записи символа пауза не нужна, для очистки -- около 20 байт.
+ *  	Если кадр переполнен, он отправляется и начинается заново
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт команды/данных
+ *  @param [in] add  RS_MSK для данных, 0 для команды
+ *  @param [in] us   время выполнения инструкции, мкс
+ *  @return None
+ */
+static void s_frame_op (LCD_HandleTypeDef *hlcd, uint8_t data, uint8_t add, uint32_t us)
+{
+	pcf_ctx_t *ctx = (pcf_ctx_t *) hlcd->Context;
+	uint32_t pad = (us * 1000U + ctx->byte_ns - 1) / ctx->byte_ns;
+	pad = (pad > 1) ? pad - 1 : 0; // Первый байт следующей инструкции тоже пауза
+	if (ctx->len + 4 + pad > LCD_PCF8574T_FRAME_SIZE)
+	{
+		s_frame_end(hlcd);
+		s_frame_begin(hlcd);
+	}
+	uint8_t *frame = ctx->frame[ctx->fill];
+	s_encode_2x4bit(&frame[ctx->len], data, add, EN_MASK(hlcd));
+	ctx->len += 4;
+	while (pad --)
+		frame[ctx->len ++] = BKL_MSK | add;
+}
+
+#if (LCD_PCF8574T_DMA != 0)
+/** @brief Восстановление дисплея после потерянного кадра
+ *  @note
+ *  	Кадр мог дойти до дисплея частично, поэтому состояние
+ *  	контроллера неизвестно: счётчик адреса сбрасывается, весь
+ *  	теневой буфер отправляется заново (LCD_TransportLost), а
+ *  	регистры дисплея и сдвиг изображения -- в начале нового кадра
+ *  	по теневым регистрам. Эти инструкции идут мимо учёта
+ *  	lcd_data_transport.c: теневые регистры уже такие
+ *  @param [in] ctx контекст дисплея
+ *  @return None
+ */
+static void s_recover (pcf_ctx_t *ctx)
+{
+	LCD_HandleTypeDef *hlcd = ctx->hlcd;
+	while (ctx->queued || s_i2c_bus[ctx->bus].owner)
+		; // Дождаться остальных кадров, устройство проверяется на свободной шине
+	ctx->error = 0;
+	if (HAL_I2C_IsDeviceReady(ctx->hi2c, ctx->addr, 10, I2C_TIMEOUT_MS) != HAL_OK)
+	{
+		Error_Handler();
+	}
+	LCD_TransportLost(hlcd);
+	uint8_t enable = hlcd->Enable;
+	hlcd->Enable = hlcd->Geometry->E2Row ? LCD_ENABLE_BOTH : LCD_ENABLE_E1; // Оба контроллера 40x4
+	if (hlcd->FunctionSet)
+		s_frame_command(hlcd, hlcd->FunctionSet);
+	if (hlcd->DisplayControl)
+		s_frame_command(hlcd, hlcd->DisplayControl);
+	s_frame_command(hlcd, hlcd->EntryMode);
+	s_frame_command(hlcd, 0b00000010); // Сдвиг изображения 0
+	for (uint8_t i = 0; i < hlcd->Shift; i ++)
+		s_frame_command(hlcd, 0b00011000);
+	hlcd->Enable = enable;
+}
+#endif
+
+/** @brief Начало кадра
+ *  @note
+ *  	С DMA кадр заполняется в свободном буфере, пока второй
+ *  	ещё в очереди шины или передаётся. Ожидание -- только
+ *  	если заняты оба буфера дисплея. Если кадр дисплея потерян
+ *  	(ошибка I2C), новый кадр начинается с восстановления (s_recover)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_begin (LCD_HandleTypeDef *hlcd)
+{
+	pcf_ctx_t *ctx = (pcf_ctx_t *) hlcd->Context;
+#if (LCD_PCF8574T_DMA != 0)
+	while (ctx->queued >= I2C_FRAME_BUFFERS)
+		;
+#endif
+	ctx->len = 0;
+#if (LCD_PCF8574T_DMA != 0)
+	if (ctx->error)
+		s_recover(ctx);
+#endif
+}
+
+/** @brief Добавляет в кадр команду
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] cmd  код команды
+ *  @return None
+ */
+static void s_frame_command (LCD_HandleTypeDef *hlcd, uint8_t cmd)
+{
+	s_frame_op(hlcd, cmd, 0, LCD_InstrTimeUs(LCD_InstrClassify(cmd)));
+}
+
+/** @brief Добавляет в кадр байт данных
+ *  @param [in] hlcd дескриптор дисплея
+ *  @param [in] data байт данных
+ *  @return None
+ */
+static void s_frame_data (LCD_HandleTypeDef *hlcd, uint8_t data)
+{
+	s_frame_op(hlcd, data, RS_MSK, LCD_InstrTimeUs(LCD_INSTR_DATA));
+}
+
+#if (LCD_PCF8574T_DMA != 0)
+/** @brief Запускает передачу кадра через DMA
+ *  @note
+ *  	Если запуск не удался, кадр теряется (следующий кадр
+ *  	дисплея восстановит его, s_recover) и запускается следующий в очереди
+ *  @param [in] job кадр
+ *  @return None
+ */
+static void s_i2c_transmit (const i2c_job_t *job)
+{
+	pcf_ctx_t *ctx = job->ctx;
+	if (HAL_I2C_Master_Transmit_DMA(ctx->hi2c, ctx->addr, ctx->frame[job->buf], job->len) == HAL_OK)
+		return;
+	ctx->error = 1;
+	ctx->queued --;
+	s_i2c_next(&s_i2c_bus[ctx->bus]);
+}
+
+/** @brief Передача следующего кадра очереди шины
+ *  @note
+ *  	Вызывается из прерывания окончания передачи, поэтому
+ *  	шина не простаивает между кадрами разных дисплеев
+ *  @param [in] bus шина
+ *  @return None
+ */
+static void s_i2c_next (i2c_bus_t *bus)
+{
+	if (bus->tail == bus->head)
+	{
+		bus->owner = NULL;
+		return;
+	}
+	const i2c_job_t *job = &bus->queue[bus->tail];
+	bus->tail = (uint8_t) ((bus->tail + 1) % I2C_QUEUE_SIZE);
+	bus->owner = job->ctx;
+	s_i2c_transmit(job);
+}
+
+/** @brief Шина по дескриптору HAL
+ *  @param [in] hi2c дескриптор I2C
+ *  @return шина или NULL, если на ней нет дисплеев
+ */
+static i2c_bus_t *s_i2c_find (I2C_HandleTypeDef *hi2c)
+{
+	for (uint8_t k = 0; k < I2C_BUSES; k ++)
+	{
+		if (s_i2c_bus[k].hi2c == hi2c)
+			return &s_i2c_bus[k];
+	}
+	return NULL;
+}
+
+/** @brief Ставит кадр в очередь шины и сразу возвращается
+ *  @note
+ *  	Кадры всех дисплеев шины передаются через DMA в порядке
+ *  	вызова LCD_FrameEnd, следующий запускается из прерывания
+ *  	окончания предыдущего. Очереди разных шин независимы,
+ *  	их кадры передаются одновременно. Если шина свободна, передача
+ *  	начинается сразу. После постановки заполняемым становится
+ *  	другой буфер. Ошибку передачи обработает следующий
+ *  	LCD_FrameBegin дисплея (s_recover).
+ *  	По окончании вызывается LCD_FrameCompleteCallback (из прерывания)
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_end (LCD_HandleTypeDef *hlcd)
+{
+	pcf_ctx_t *ctx = (pcf_ctx_t *) hlcd->Context;
+	i2c_bus_t *bus = &s_i2c_bus[ctx->bus];
+	if (ctx->len == 0)
+	{
+		LCD_FrameCompleteCallback(hlcd);
+		return;
+	}
+	i2c_job_t job = { ctx, ctx->fill, ctx->len };
+	uint8_t start;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	ctx->queued ++;
+	start = (bus->owner == NULL);
+	if (start)
+		bus->owner = ctx;
+	else
+	{
+		bus->queue[bus->head] = job;
+		bus->head = (uint8_t) ((bus->head + 1) % I2C_QUEUE_SIZE);
+	}
+	__set_PRIMASK(primask);
+
+	if (start)
+		s_i2c_transmit(&job);
+	ctx->fill ^= 1;
+	ctx->len = 0;
+}
+
+/** @brief Проверка, что следующий кадр дисплея придётся ждать
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 1 -- оба буфера кадра в очереди шины или передаются, 0 -- есть свободный
+ */
+static uint8_t s_frame_busy (LCD_HandleTypeDef *hlcd)
+{
+	return ((pcf_ctx_t *) hlcd->Context)->queued >= I2C_FRAME_BUFFERS;
+}
+
+/** @brief Конец передачи кадра через DMA
+ *  @note
+ *  	Вызывается из HAL_I2C_MasterTxCpltCallback приложения:
+ *  	обработчики HAL остаются за приложением и другими
+ *  	устройствами на шинах I2C. Шины без дисплеев пропускаются
+ *  @param [in] hi2c дескриптор I2C
+ *  @return None
+ */
+void LCD_I2cTxCplt (I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_t *bus = s_i2c_find(hi2c);
+	pcf_ctx_t *ctx = bus ? bus->owner : NULL;
+	if (ctx == NULL)
+		return;
+	ctx->queued --;
+	s_i2c_next(bus);
+	LCD_FrameCompleteCallback(ctx->hlcd);
+}
+
+/** @brief Ошибка передачи кадра через DMA
+ *  @note
+ *  	Вызывается из HAL_I2C_ErrorCallback приложения. Кадр
+ *  	теряется, следующий кадр этого дисплея проверит устройство
+ *  	и восстановит дисплей (s_recover)
+ *  @param [in] hi2c дескриптор I2C
+ *  @return None
+ */
+void LCD_I2cError (I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_t *bus = s_i2c_find(hi2c);
+	pcf_ctx_t *ctx = bus ? bus->owner : NULL;
+	if (ctx == NULL)
+		return;
+	ctx->error = 1;
+	ctx->queued --;
+	s_i2c_next(bus);
+}
+
+/** @brief Проверка, что на шине ещё передаются кадры
+ *  @param [in] hi2c дескриптор I2C
+ *  @return 1 -- очередь кадров шины не пуста, 0 -- шина свободна
+ */
+uint8_t LCD_I2cBusy (I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_t *bus = s_i2c_find(hi2c);
+	return bus != NULL && bus->owner != NULL;
+}
+
+/** @brief Обработчики прерываний потока DMA1 и контроллера I2C шины
+ *  @note
+ *  	Вызываются из DMA1_StreamN_IRQHandler, I2Cx_EV_IRQHandler
+ *  	и I2Cx_ER_IRQHandler (stm32f4xx_it.c). Прерывания шины
+ *  	без дисплеев не включаются, вызов для неё пустой
+ *  @param [in] instance контроллер I2C1, I2C2 или I2C3
+ *  @return None
+ */
+void LCD_I2cDmaIRQHandler (I2C_TypeDef *instance)
+{
+	for (uint8_t k = 0; k < I2C_BUSES; k ++)
+	{
+		if (s_i2c_hw[k].instance == instance && s_i2c_bus[k].hi2c)
+			HAL_DMA_IRQHandler(&s_i2c_bus[k].hdma);
+	}
+}
+
+void LCD_I2cEvIRQHandler (I2C_TypeDef *instance)
+{
+	for (uint8_t k = 0; k < I2C_BUSES; k ++)
+	{
+		if (s_i2c_hw[k].instance == instance && s_i2c_bus[k].hi2c)
+			HAL_I2C_EV_IRQHandler(s_i2c_bus[k].hi2c);
+	}
+}
+
+void LCD_I2cErIRQHandler (I2C_TypeDef *instance)
+{
+	for (uint8_t k = 0; k < I2C_BUSES; k ++)
+	{
+		if (s_i2c_hw[k].instance == instance && s_i2c_bus[k].hi2c)
+			HAL_I2C_ER_IRQHandler(s_i2c_bus[k].hi2c);
+	}
+}
+#else
+/** @brief Отправляет кадр одной транзакцией I2C
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return None
+ */
+static void s_frame_end (LCD_HandleTypeDef *hlcd)
+{
+	pcf_ctx_t *ctx = (pcf_ctx_t *) hlcd->Context;
+	if (ctx->len)
+		s_transmit(ctx, ctx->frame[ctx->fill], ctx->len);
+	ctx->len = 0;
+	LCD_FrameCompleteCallback(hlcd);
+}
+
+/** @brief Проверка, что кадр ещё выводится
+ *  @param [in] hlcd дескриптор дисплея
+ *  @return 0 -- кадр отправляется блокирующей транзакцией
+ */
+static uint8_t s_frame_busy (LCD_HandleTypeDef *hlcd)
+{
+	(void) hlcd;
+	return 0;
+}
+
+/** @brief Проверка, что на шине ещё передаются кадры
+ *  @param [in] hi2c дескриптор I2C
+ *  @return 0 -- кадры передаются блокирующими транзакциями
+ */
+uint8_t LCD_I2cBusy (I2C_HandleTypeDef *hi2c)
+{
+	(void) hi2c;
+	return 0;
+}
+#endif
+
+/// Операции транспорта PCF8574T
+const LCD_TransportTypeDef LCD_TransportPCF8574T = {
+	.Width        = LCD_DATA_WIDTH_HALF_BYTE,
+	.Init         = s_transport_init,
+	.SendCommand  = s_send_command,
+	.SendData     = s_send_data,
+	.FrameBegin   = s_frame_begin,
+	.FrameCommand = s_frame_command,
+	.FrameData    = s_frame_data,
+	.FrameEnd     = s_frame_end,
+	.FrameBusy    = s_frame_busy,
+	.ByteTimeNs   = s_byte_time_ns,
+};
+#endif
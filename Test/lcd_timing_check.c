@@ -0,0 +1,127 @@
+/*
+ * lcd_timing_check.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdio.h>
+
+#include "lcd_timing.h"
+
+/// Проверка lcd_timing.c на ПК: каждый код команды 0x00-0xFF проходит
+/// через LCD_InstrClassify и LCD_InstrTimeUs, класс и время ожидания
+/// сравниваются с инструкцией и её временем по спецификации контроллера.
+/// Собирается для каждого профиля LCD_CONTROLLER (Makefile)
+
+/// Времена выполнения по спецификациям, мкс (fosc = 270 КГц)
+typedef struct {
+	const char *name;  ///?> Контроллер
+	uint16_t    clear; ///?> Clear Display
+	uint16_t    home;  ///?> Return Home
+	uint16_t    cmd;   ///?> Остальные команды
+	uint16_t    data;  ///?> Write Data: запись + tADD
+} spec_t;
+
+#if (LCD_CONTROLLER == LCD_CONTROLLER_HD44780)
+static const spec_t s_spec = { "HD44780", 1520, 1520, 37, 37 + 4 };
+#elif (LCD_CONTROLLER == LCD_CONTROLLER_ST7066U)
+static const spec_t s_spec = { "ST7066U", 1520, 1520, 37, 37 + 6 };
+#elif (LCD_CONTROLLER == LCD_CONTROLLER_SPLC780D)
+static const spec_t s_spec = { "SPLC780D", 1520, 1520, 37, 37 + 6 };
+#elif (LCD_CONTROLLER == LCD_CONTROLLER_KS0066)
+static const spec_t s_spec = { "KS0066", 1530, 1530, 39, 39 + 4 };
+#else
+#error "Нет спецификации для LCD_CONTROLLER"
+#endif
+
+/// Коды инструкций по таблице спецификации: код & mask == code
+typedef struct {
+	uint8_t        mask;  ///?> Значащие биты кода
+	uint8_t        code;  ///?> Значение значащих бит
+	LCD_InstrClass instr; ///?> Инструкция
+} instr_code_t;
+
+static const instr_code_t s_codes[] = {
+	{ 0xFF, 0x01, LCD_INSTR_CLEAR },
+	{ 0xFE, 0x02, LCD_INSTR_HOME },
+	{ 0xFC, 0x04, LCD_INSTR_ENTRY_MODE },
+	{ 0xF8, 0x08, LCD_INSTR_DISPLAY_CONTROL },
+	{ 0xF0, 0x10, LCD_INSTR_SHIFT },
+	{ 0xE0, 0x20, LCD_INSTR_FUNCTION_SET },
+	{ 0xC0, 0x40, LCD_INSTR_CGRAM_ADDRESS },
+	{ 0x80, 0x80, LCD_INSTR_DDRAM_ADDRESS },
+};
+
+/** @brief Инструкция по коду команды из таблицы спецификации
+ *  @note
+ *  	Код 0x00 инструкцией не является, драйвер ждёт его
+ *  	как самую медленную (очистку экрана)
+ *  @param [in] cmd код команды
+ *  @return инструкция
+ */
+static LCD_InstrClass s_decode (uint8_t cmd)
+{
+	for (unsigned i = 0; i < sizeof(s_codes) / sizeof(s_codes[0]); i ++)
+	{
+		if ((cmd & s_codes[i].mask) == s_codes[i].code)
+			return s_codes[i].instr;
+	}
+	return LCD_INSTR_CLEAR;
+}
+
+/** @brief Время выполнения инструкции по спецификации
+ *  @param [in] instr инструкция
+ *  @return время, мкс (fosc = 270 КГц)
+ */
+static uint32_t s_spec_us (LCD_InstrClass instr)
+{
+	switch (instr)
+	{
+	case LCD_INSTR_CLEAR: return s_spec.clear;
+	case LCD_INSTR_HOME:  return s_spec.home;
+	case LCD_INSTR_DATA:  return s_spec.data;
+	default:              return s_spec.cmd;
+	}
+}
+
+/** @brief Проверка времени ожидания инструкции
+ *  @note
+ *  	Ожидание должно покрыть время по спецификации на самой низкой
+ *  	частоте генератора (t * 270 / LCD_TIMING_FOSC_MIN_KHZ) и не быть
+ *  	больше вдвое -- иначе инструкция ждёт время чужого класса
+ *  @param [in] what  название для сообщения
+ *  @param [in] instr инструкция по спецификации
+ *  @param [in] wait  время ожидания драйвера, мкс
+ *  @return число ошибок
+ */
+static unsigned s_check_wait (const char *what, LCD_InstrClass instr, uint32_t wait)
+{
+	uint32_t need = (s_spec_us(instr) * 270U + LCD_TIMING_FOSC_MIN_KHZ - 1) / LCD_TIMING_FOSC_MIN_KHZ;
+	if (wait >= need && wait <= 2U * need)
+		return 0;
+	printf("%s: %s: ожидание %lu мкс, по спецификации %lu мкс на %d КГц\n",
+	       s_spec.name, what, (unsigned long) wait, (unsigned long) need, LCD_TIMING_FOSC_MIN_KHZ);
+	return 1;
+}
+
+int main (void)
+{
+	unsigned errors = 0;
+	char what[32];
+	for (unsigned cmd = 0; cmd <= 0xFF; cmd ++)
+	{
+		LCD_InstrClass expect = s_decode((uint8_t) cmd);
+		LCD_InstrClass instr  = LCD_InstrClassify((uint8_t) cmd);
+		snprintf(what, sizeof(what), "команда 0x%02X", cmd);
+		if (instr != expect)
+		{
+			printf("%s: %s: класс %d, по спецификации %d\n", s_spec.name, what, (int) instr, (int) expect);
+			errors ++;
+			continue;
+		}
+		errors += s_check_wait(what, expect, LCD_InstrTimeUs(instr));
+	}
+	errors += s_check_wait("запись данных", LCD_INSTR_DATA, LCD_InstrTimeUs(LCD_INSTR_DATA));
+	printf("%s: %u ошибок\n", s_spec.name, errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: denis
+ */
+#include <stdint.h>
+
+#ifndef TEST_MAIN_H_
+#define TEST_MAIN_H_
+
+/// Замена Core/Inc/main.h для сборки lcd_timing.c на ПК:
+/// из CMSIS нужен только __CLZ
+
+/** @brief Число старших нулевых бит (как инструкция CLZ Cortex-M)
+ *  @param [in] value слово
+ *  @return 0-32
+ */
+static inline uint32_t __CLZ (uint32_t value)
+{
+	return value ? (uint32_t) __builtin_clz(value) : 32U;
+}
+
+#endif /* TEST_MAIN_H_ */